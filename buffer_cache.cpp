@@ -0,0 +1,233 @@
+#include "buffer_cache.h"
+#include "thread_counters.h"
+
+#include <atomic>
+#include <bit>
+#include <new>
+#include <algorithm>
+
+namespace lab::buffer_cache {
+
+    /*
+     * Internal types
+     */
+
+    static constexpr size_t class_count = std::countr_zero(max_block_size) - std::countr_zero(min_block_size) + 1;
+
+    static constexpr size_t block_alignment = alignof(std::max_align_t);
+
+    static_assert(std::has_single_bit(min_block_size) && std::has_single_bit(max_block_size));
+
+    using thread_counters::Counter;
+
+    /**
+     * @brief Cached buffer, the link is stored in the buffer itself
+     */
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    /**
+     * @brief Cached buffers of a single size class
+     */
+    struct FreeList {
+
+        /**
+         * @brief The most recently freed buffer
+         */
+        FreeBlock *head = nullptr;
+
+        /**
+         * @brief Number of cached buffers
+         */
+        size_t count = 0;
+
+        /**
+         * @brief Minimal number of cached buffers since the last trim, so many buffers have not been reused
+         */
+        size_t low_water = 0;
+    };
+
+    static std::atomic<size_t> max_blocks_per_class{Limits().max_blocks_per_class},
+            max_cached_bytes{Limits().max_cached_bytes}, trim_interval{Limits().trim_interval};
+
+    static inline size_t class_of(const size_t bytes) noexcept {
+        return std::countr_zero(std::bit_ceil(std::max(bytes, min_block_size))) - std::countr_zero(min_block_size);
+    }
+
+    static inline size_t size_of_class(const size_t index) noexcept {
+        return min_block_size << index;
+    }
+
+    static inline bool is_cacheable(const size_t bytes, const size_t alignment) noexcept {
+        return bytes <= max_block_size && alignment <= block_alignment;
+    }
+
+    static inline std::pmr::memory_resource *upstream() noexcept {
+        return std::pmr::new_delete_resource();
+    }
+
+    struct ThreadCache {
+        FreeList lists[class_count];
+        Counter hits, misses, bypasses, evictions, cached_bytes;
+        size_t frees_since_trim = 0;
+
+        /**
+         * @brief Frees all cached buffers once the thread finishes
+         */
+        void retire() noexcept {
+            release_all();
+        }
+
+        void add_to(Statistics &statistics) const noexcept {
+            statistics.hits += hits.get();
+            statistics.misses += misses.get();
+            statistics.bypasses += bypasses.get();
+            statistics.evictions += evictions.get();
+            statistics.cached_bytes += cached_bytes.get();
+        }
+
+        /**
+         * @brief Frees the given number of the most recently cached buffers of the size class
+         */
+        void release(const size_t index, size_t count) noexcept {
+            auto &list = lists[index];
+            const auto size = size_of_class(index);
+
+            count = std::min(count, list.count);
+            for (size_t i = 0; i < count; ++i) {
+                const auto block = list.head;
+                list.head = block->next;
+                upstream()->deallocate(block, size, block_alignment);
+            }
+            list.count -= count;
+            list.low_water = std::min(list.low_water, list.count);
+            cached_bytes.subtract(count * size);
+            evictions.add(count);
+        }
+
+        void release_all() noexcept {
+            for (size_t index = 0; index < class_count; ++index) release(index, lists[index].count);
+        }
+
+        /**
+         * @brief Frees the buffers which have not been needed since the previous trim
+         */
+        void trim_idle() noexcept {
+            for (size_t index = 0; index < class_count; ++index) {
+                auto &list = lists[index];
+                release(index, list.low_water);
+                list.low_water = list.count;
+            }
+            frees_since_trim = 0;
+        }
+
+        void *allocate(const size_t index) {
+            auto &list = lists[index];
+            const auto block = list.head;
+            if (block == nullptr) {
+                misses.add(1);
+                return upstream()->allocate(size_of_class(index), block_alignment);
+            }
+
+            list.head = block->next;
+            list.low_water = std::min(list.low_water, --list.count);
+            cached_bytes.subtract(size_of_class(index));
+            hits.add(1);
+
+            return block;
+        }
+
+        void deallocate(void *const pointer, const size_t index) noexcept {
+            auto &list = lists[index];
+            const auto size = size_of_class(index);
+
+            if (list.count >= max_blocks_per_class.load(std::memory_order_relaxed)
+                || cached_bytes.get() + size > max_cached_bytes.load(std::memory_order_relaxed)) {
+                upstream()->deallocate(pointer, size, block_alignment);
+                evictions.add(1);
+            } else {
+                list.head = new(pointer) FreeBlock{list.head};
+                ++list.count;
+                cached_bytes.add(size);
+            }
+
+            if (++frees_since_trim >= trim_interval.load(std::memory_order_relaxed)) trim_idle();
+        }
+    };
+
+    /**
+     * @brief Registry of the thread caches, late frees of a finished thread go directly to the upstream
+     */
+    using Registry = thread_counters::Registry<ThreadCache, Statistics>;
+
+    static ThreadCache &thread_cache() {
+        return Registry::local();
+    }
+
+    static bool thread_finished() noexcept {
+        return Registry::finished();
+    }
+
+    /**
+     * @brief Memory resource forwarding to the calling thread's cache
+     */
+    class CachingResource : public std::pmr::memory_resource {
+    protected:
+        void *do_allocate(const size_t bytes, const size_t alignment) override {
+            if (!is_cacheable(bytes, alignment)) {
+                if (!thread_finished()) thread_cache().bypasses.add(1);
+                return upstream()->allocate(bytes, alignment);
+            }
+
+            // any thread may cache the block once it is freed so it always has the size of its class
+            const auto index = class_of(bytes);
+            if (thread_finished()) return upstream()->allocate(size_of_class(index), block_alignment);
+
+            return thread_cache().allocate(index);
+        }
+
+        void do_deallocate(void *const pointer, const size_t bytes, const size_t alignment) override {
+            if (!is_cacheable(bytes, alignment)) upstream()->deallocate(pointer, bytes, alignment);
+            else if (thread_finished())
+                upstream()->deallocate(pointer, size_of_class(class_of(bytes)), block_alignment);
+            else thread_cache().deallocate(pointer, class_of(bytes));
+        }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            // buffers may be freed by any thread so there is effectively a single cache
+            return this == &other;
+        }
+    };
+
+    /*
+     * Public functions
+     */
+
+    std::pmr::memory_resource *resource() noexcept {
+        static CachingResource resource;
+        return &resource;
+    }
+
+    Limits limits() noexcept {
+        return Limits{
+                max_blocks_per_class.load(std::memory_order_relaxed),
+                max_cached_bytes.load(std::memory_order_relaxed),
+                trim_interval.load(std::memory_order_relaxed)
+        };
+    }
+
+    void set_limits(const Limits &limits) noexcept {
+        max_blocks_per_class.store(limits.max_blocks_per_class, std::memory_order_relaxed);
+        max_cached_bytes.store(limits.max_cached_bytes, std::memory_order_relaxed);
+        trim_interval.store(std::max(limits.trim_interval, size_t(1)), std::memory_order_relaxed);
+    }
+
+    Statistics statistics() noexcept {
+        return Registry::total();
+    }
+
+    void trim() noexcept {
+        if (!thread_finished()) thread_cache().release_all();
+    }
+}
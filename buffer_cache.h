@@ -0,0 +1,114 @@
+#ifndef SEM_2_LAB_1_BUFFER_CACHE_H
+#define SEM_2_LAB_1_BUFFER_CACHE_H
+
+
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * @brief Thread-local cache of freed buffers grouped by power-of-two size classes
+ *
+ * @note the cache is opt-in: it is used by the strings created with {@link #resource()}
+ * or by all strings if it is made the default resource using {@code std::pmr::set_default_resource}
+ * @note a buffer freed by a thread is cached by this thread even if it was allocated by another one
+ */
+namespace lab::buffer_cache {
+
+    /**
+     * @brief Size of the smallest size class in bytes
+     */
+    constexpr size_t min_block_size = 64;
+
+    /**
+     * @brief Size of the biggest size class in bytes, bigger buffers are not cached
+     */
+    constexpr size_t max_block_size = 64 * 1024;
+
+    /**
+     * @brief Limits of each thread's cache
+     */
+    struct Limits {
+
+        /**
+         * @brief Maximal number of cached buffers of a single size class
+         */
+        size_t max_blocks_per_class = 32;
+
+        /**
+         * @brief Maximal number of bytes cached by a thread
+         */
+        size_t max_cached_bytes = 1024 * 1024;
+
+        /**
+         * @brief Number of buffers freed by a thread between periodic trims of its cache,
+         * each trim frees the buffers which have not been reused since the previous one
+         */
+        size_t trim_interval = 4096;
+    };
+
+    /**
+     * @brief Counters of the cache summed over all threads
+     */
+    struct Statistics {
+
+        /**
+         * @brief Number of allocations served by a cached buffer
+         */
+        size_t hits;
+
+        /**
+         * @brief Number of cacheable allocations which had to allocate a new buffer
+         */
+        size_t misses;
+
+        /**
+         * @brief Number of allocations which are too big (or too aligned) to be cached
+         */
+        size_t bypasses;
+
+        /**
+         * @brief Number of buffers freed instead of being cached because of the limits or trimming
+         */
+        size_t evictions;
+
+        /**
+         * @brief Number of bytes currently cached by the live threads
+         */
+        size_t cached_bytes;
+    };
+
+    /**
+     * @brief Gets the memory resource allocating from the calling thread's cache
+     *
+     * @return memory resource of the cache which lives until the program ends
+     */
+    [[nodiscard]] std::pmr::memory_resource *resource() noexcept;
+
+    /**
+     * @brief Gets the current limits of the cache
+     *
+     * @return limits of each thread's cache
+     */
+    [[nodiscard]] Limits limits() noexcept;
+
+    /**
+     * @brief Changes the limits of the cache
+     *
+     * @param limits new limits of each thread's cache, they are applied as the buffers get freed
+     */
+    void set_limits(const Limits &limits) noexcept;
+
+    /**
+     * @brief Gets the counters of the cache
+     *
+     * @return snapshot of the counters of all threads including the finished ones
+     */
+    [[nodiscard]] Statistics statistics() noexcept;
+
+    /**
+     * @brief Frees all buffers cached by the calling thread
+     */
+    void trim() noexcept;
+}
+
+#endif //SEM_2_LAB_1_BUFFER_CACHE_H
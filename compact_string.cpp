@@ -0,0 +1,497 @@
+#include "compact_string.h"
+#include "search_pattern.h"
+#include "simd_kernels.h"
+#include "string_output.h"
+
+#include <cstring>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+namespace lab {
+
+    /*
+     * Static functions
+     */
+
+    /**
+     * @brief Gets the code point of the given wide character as an unsigned value
+     *
+     * @param character wide character
+     * @return code point of the character
+     */
+    static inline std::uint32_t code_point_of(const wchar_t character) {
+        return static_cast<std::uint32_t>(static_cast<std::make_unsigned_t<wchar_t>>(character));
+    }
+
+    /**
+     * @brief Gets the narrowest width which can store the given code point
+     *
+     * @param code_point code point (or bitwise-or of multiple code points)
+     * @return {@code 1}, {@code 2} or {@code 4}
+     */
+    static inline unsigned char width_of(const std::uint32_t code_point) {
+        if (code_point <= 0xFFu) return 1;
+        if (code_point <= 0xFFFFu) return 2;
+        return 4;
+    }
+
+    /**
+     * @brief Gets the biggest code point which can be stored using the given width
+     *
+     * @param width width of the storage
+     * @return biggest code point of the width
+     */
+    static inline std::uint32_t max_code_point_of(const unsigned char width) {
+        return width == 1 ? 0xFFu : width == 2 ? 0xFFFFu : 0xFFFFFFFFu;
+    }
+
+    /**
+     * @brief Calls the given function with the buffer cast to the pointer to the code unit of the given width
+     *
+     * @param buffer buffer whose code units are of the given width
+     * @param width width of the buffer's code units
+     * @param function function to call
+     * @return value returned by the function
+     */
+    template<typename TBuffer, typename TFunction>
+    static inline decltype(auto) with_code_units(TBuffer *const buffer, const unsigned char width,
+                                                 TFunction &&function) {
+        using byte_type = std::conditional_t<std::is_const_v<TBuffer>, const std::uint8_t, std::uint8_t>;
+        using word_type = std::conditional_t<std::is_const_v<TBuffer>, const std::uint16_t, std::uint16_t>;
+        using dword_type = std::conditional_t<std::is_const_v<TBuffer>, const std::uint32_t, std::uint32_t>;
+
+        switch (width) {
+            case 1: return function(static_cast<byte_type *>(buffer));
+            case 2: return function(static_cast<word_type *>(buffer));
+            default: return function(static_cast<dword_type *>(buffer));
+        }
+    }
+
+    /**
+     * @brief Gets the narrowest width which can store all of the given code units
+     *
+     * @param buffer code units to check
+     * @param length number of code units
+     * @return {@code 1}, {@code 2} or {@code 4}
+     */
+    template<typename TCodeUnit>
+    static inline unsigned char required_width_of(const TCodeUnit *const buffer, const size_t length) {
+        if constexpr (sizeof(TCodeUnit) == 1) return 1;
+        else {
+            // bitwise-or is enough as all thresholds are of form 2^n - 1 and it vectorizes well
+            std::uint32_t accumulated = 0;
+            for (size_t i = 0; i < length; ++i) accumulated |= code_point_of(wchar_t(buffer[i]));
+
+            return width_of(accumulated);
+        }
+    }
+
+    /**
+     * @brief Copies code units converting them to the other width
+     *
+     * @param source buffer to copy from
+     * @param source_width width of the source's code units
+     * @param length number of code units to copy
+     * @param destination buffer to copy to
+     * @param destination_width width of the destination's code units
+     * @note all copied code units should fit into the destination width
+     */
+    static void copy_converting(const void *const source, const unsigned char source_width, const size_t length,
+                                void *const destination, const unsigned char destination_width) {
+        if (length == 0) return;
+        if (source_width == destination_width) {
+            std::memcpy(destination, source, length * source_width);
+            return;
+        }
+
+        with_code_units(source, source_width, [&](auto source_units) {
+            with_code_units(destination, destination_width, [&](auto destination_units) {
+                using destination_type = std::remove_pointer_t<decltype(destination_units)>;
+                for (size_t i = 0; i < length; ++i) destination_units[i] = destination_type(source_units[i]);
+            });
+        });
+    }
+
+    /*
+     * Protected constructors
+     */
+
+    CompactString::CompactString(const size_t length, const unsigned char width)
+            : buffer_(length == 0 ? nullptr : ::operator new(length * width)),
+              capacity_(length), length_(length), width_(width) {}
+
+    /*
+     * Internal methods
+     */
+
+    void CompactString::check_index(const size_t index) const noexcept(false) {
+        if (index >= length_) throw std::out_of_range("Index " + std::to_string(index) + " exceeds string length");
+    }
+
+    void CompactString::ensure_capacity(const size_t required_capacity, const unsigned char required_width) {
+        const auto capacity = capacity_;
+        // the buffer grows the same way as the one of SimpleString
+        const auto new_capacity = [capacity, required_capacity](const unsigned char width) {
+            return SimpleString::calculate_new_capacity(SimpleString::default_growth_policy,
+                                                        capacity, required_capacity, width, 0);
+        };
+        if (required_width > width_) resize_to(
+                capacity < required_capacity ? new_capacity(required_width) : capacity, required_width
+        );
+        else if (capacity < required_capacity) resize_to(new_capacity(width_), width_);
+    }
+
+    void CompactString::resize_to(const size_t new_capacity, const unsigned char new_width) {
+        if (capacity_ != new_capacity || width_ != new_width) {
+            const auto new_buffer = new_capacity == 0 ? nullptr : ::operator new(new_capacity * new_width);
+            const auto new_length = std::min(length_, new_capacity);
+
+            copy_converting(buffer_, width_, new_length, new_buffer, new_width);
+            ::operator delete(buffer_);
+            buffer_ = new_buffer;
+
+            capacity_ = new_capacity;
+            length_ = new_length;
+            width_ = new_width;
+        }
+    }
+
+    /*
+     * Public constructors
+     */
+
+    CompactString::CompactString() : CompactString(0, 1) {}
+
+    CompactString::CompactString(wchar_t const *const wide_c_string) : CompactString() {
+        const auto length = wcslen(wide_c_string);
+        const auto width = required_width_of(wide_c_string, length);
+
+        resize_to(length, width);
+        with_code_units(buffer_, width, [&](auto units) {
+            using unit_type = std::remove_pointer_t<decltype(units)>;
+            for (size_t i = 0; i < length; ++i) units[i] = unit_type(code_point_of(wide_c_string[i]));
+        });
+        length_ = length;
+    }
+
+    CompactString::CompactString(const SimpleString &original) : CompactString() {
+        const auto length = original.length_;
+        const auto original_buffer = original.buffer_;
+        const auto width = required_width_of(original_buffer, length);
+
+        resize_to(length, width);
+        with_code_units(buffer_, width, [&](auto units) {
+            using unit_type = std::remove_pointer_t<decltype(units)>;
+            for (size_t i = 0; i < length; ++i) units[i] = unit_type(code_point_of(original_buffer[i]));
+        });
+        length_ = length;
+    }
+
+    /*
+     * Special constructors
+     */
+
+    CompactString::CompactString(const CompactString &original) : CompactString(
+            original.length_,
+            with_code_units(original.buffer_, original.width_, [&](auto units) {
+                return required_width_of(units, original.length_);
+            })
+    ) {
+        copy_converting(original.buffer_, original.width_, length_, buffer_, width_);
+    }
+
+    CompactString::CompactString(CompactString &&original) noexcept
+            : buffer_(std::exchange(original.buffer_, nullptr)),
+              capacity_(std::exchange(original.capacity_, 0)), length_(std::exchange(original.length_, 0)),
+              width_(std::exchange(original.width_, 1)) {}
+
+    /*
+     * Public destructor
+     */
+
+    CompactString::~CompactString() {
+        ::operator delete(buffer_);
+    }
+
+    /*
+     * Constant public methods
+     */
+
+    size_t CompactString::length() const noexcept {
+        return length_;
+    }
+
+    bool CompactString::empty() const noexcept {
+        return length_ == 0;
+    }
+
+    unsigned char CompactString::width() const noexcept {
+        return width_;
+    }
+
+    std::optional<size_t> CompactString::index_of(const wchar_t character) const noexcept {
+        const auto length = length_;
+        const auto code_point = code_point_of(character);
+        // no stored character can be wider than the buffer
+        if (length == 0 || code_point > max_code_point_of(width_)) return std::optional<size_t>();
+
+        if (width_ == 1) {
+            const auto buffer = static_cast<const std::uint8_t *>(buffer_);
+            const auto found = static_cast<const std::uint8_t *>(std::memchr(buffer, int(code_point), length));
+            return found == nullptr ? std::optional<size_t>() : std::optional<size_t>(found - buffer);
+        }
+
+        size_t index;
+        if (width_ == 2) {
+            const auto units = static_cast<const std::uint16_t *>(buffer_);
+            index = simd::find_code_unit(units, length, std::uint16_t(code_point));
+        } else if constexpr (sizeof(wchar_t) == 4) {
+            // 4-byte code units are laid out as the wide characters
+            index = simd::find_character(static_cast<const wchar_t *>(buffer_), length, wchar_t(code_point));
+        } else {
+            const auto units = static_cast<const std::uint32_t *>(buffer_);
+            index = size_t(std::find(units, units + length, code_point) - units);
+        }
+
+        return index == length ? std::optional<size_t>() : std::optional<size_t>(index);
+    }
+
+    std::optional<size_t> CompactString::index_of(const char character) const noexcept {
+        return index_of(wchar_t(character));
+    }
+
+    std::optional<size_t> CompactString::index_of(const CompactString &other) const noexcept {
+        if (other.empty()) return 0;
+
+        const auto length = length_, other_length = other.length_;
+        if (other_length > length) return std::optional<size_t>();
+
+        const auto index = with_code_units(static_cast<const void *>(buffer_), width_, [&](auto units) {
+            return with_code_units(static_cast<const void *>(other.buffer_), other.width_, [&](auto other_units) {
+                return search::find_code_units(other_units, other_length, units, length);
+            });
+        });
+
+        return index == length ? std::optional<size_t>() : std::optional<size_t>(index);
+    }
+
+    wchar_t CompactString::at(const size_t index) const noexcept(false) {
+        check_index(index);
+
+        return with_code_units(static_cast<const void *>(buffer_), width_, [&](auto units) {
+            return wchar_t(units[index]);
+        });
+    }
+
+    bool CompactString::equals(const CompactString &other) const noexcept {
+        const auto length = length_;
+        if (length != other.length_) return false;
+        if (length == 0) return true;
+
+        // same widths allow comparing raw bytes
+        if (width_ == other.width_) return std::memcmp(buffer_, other.buffer_, length * width_) == 0;
+
+        return with_code_units(static_cast<const void *>(buffer_), width_, [&](auto units) {
+            return with_code_units(static_cast<const void *>(other.buffer_), other.width_, [&](auto other_units) {
+                for (size_t i = 0; i < length; ++i) if (std::uint32_t(units[i]) != std::uint32_t(other_units[i]))
+                    return false;
+
+                return true;
+            });
+        });
+    }
+
+    int CompactString::compare(const CompactString &other) const noexcept {
+        const auto length = length_, other_length = other.length_;
+
+        if (length == other_length) {
+            if (length == 0) return 0;
+
+            // bytes are ordered the same way as their code points
+            if (width_ == 1 && other.width_ == 1) {
+                const auto result = std::memcmp(buffer_, other.buffer_, length);
+                return result == 0 ? 0 : result > 0 ? 1 : -1;
+            }
+
+            return with_code_units(static_cast<const void *>(buffer_), width_, [&](auto units) {
+                return with_code_units(static_cast<const void *>(other.buffer_), other.width_, [&](auto other_units) {
+                    // characters are ordered as wchar_t values the same way as by SimpleString
+                    for (size_t i = 0; i < length; ++i) {
+                        const auto character = wchar_t(units[i]), other_character = wchar_t(other_units[i]);
+                        if (character != other_character) return character > other_character ? 1 : -1;
+                    }
+
+                    return 0;
+                });
+            });
+        }
+
+        return length > other_length ? 1 : -1;
+    }
+
+    SimpleString CompactString::to_simple_string() const {
+        const auto length = length_;
+        SimpleString result(length);
+        with_code_units(static_cast<const void *>(buffer_), width_, [&](auto units) {
+            const auto result_buffer = result.buffer_;
+            for (size_t i = 0; i < length; ++i) result_buffer[i] = wchar_t(units[i]);
+        });
+
+        return result;
+    }
+
+    /*
+     * Modifying public methods
+     */
+
+    void CompactString::shrink() {
+        resize_to(length_, with_code_units(static_cast<const void *>(buffer_), width_, [&](auto units) {
+            return required_width_of(units, length_);
+        }));
+    }
+
+    void CompactString::append(const wchar_t character) {
+        const auto length = length_, new_length = length + 1;
+        const auto code_point = code_point_of(character);
+        ensure_capacity(new_length, width_of(code_point));
+
+        with_code_units(buffer_, width_, [&](auto units) {
+            units[length] = std::remove_pointer_t<decltype(units)>(code_point);
+        });
+        length_ = new_length;
+    }
+
+    void CompactString::append(const char character) {
+        append(wchar_t(character));
+    }
+
+    void CompactString::append(const CompactString &other) {
+        const auto length = length_, other_length = other.length_, new_length = length + other_length;
+        ensure_capacity(new_length, other.width_);
+
+        // `other` may be this string so its buffer is read only after the possible reallocation
+        copy_converting(
+                other.buffer_, other.width_, other_length,
+                static_cast<std::uint8_t *>(buffer_) + length * width_, width_
+        );
+        length_ = new_length;
+    }
+
+    void CompactString::set(const size_t index, const wchar_t character) {
+        check_index(index);
+
+        const auto code_point = code_point_of(character);
+        ensure_capacity(length_, width_of(code_point));
+
+        with_code_units(buffer_, width_, [&](auto units) {
+            units[index] = std::remove_pointer_t<decltype(units)>(code_point);
+        });
+    }
+
+    /*
+     * Special operators
+     */
+
+    CompactString &CompactString::operator=(const CompactString &original) {
+        if (this != &original) {
+            const auto length = original.length_;
+            const auto width = with_code_units(static_cast<const void *>(original.buffer_), original.width_,
+                                               [&](auto units) { return required_width_of(units, length); });
+            if (length > capacity_ || width > width_) {
+                // a new buffer should be allocated
+
+                // free current buffer
+                ::operator delete(buffer_);
+
+                // it is recommended to keep defaults in case something fails later
+                buffer_ = nullptr;
+                capacity_ = length_ = 0;
+                width_ = 1;
+
+                // create needed copies and assign them to the fields
+                buffer_ = length == 0 ? nullptr : ::operator new(length * width);
+                capacity_ = length_ = length;
+                width_ = width;
+            }
+
+            // the current buffer is reused if it is large and wide enough
+            copy_converting(original.buffer_, original.width_, length, buffer_, width_);
+            length_ = length;
+        }
+
+        return *this;
+    }
+
+    CompactString &CompactString::operator=(CompactString &&original) noexcept {
+        if (this != &original) {
+            // free current buffer
+            ::operator delete(buffer_);
+
+            buffer_ = std::exchange(original.buffer_, nullptr);
+            capacity_ = std::exchange(original.capacity_, 0);
+            length_ = std::exchange(original.length_, 0);
+            width_ = std::exchange(original.width_, 1);
+        }
+
+        return *this;
+    }
+
+    /*
+     * Indexed access operators
+     */
+
+    wchar_t CompactString::operator[](const size_t index) const noexcept(false) {
+        return at(index);
+    }
+
+    /*
+     * Comparison operators
+     */
+
+    bool CompactString::operator==(const CompactString &other) const noexcept {
+        return equals(other);
+    }
+
+    bool CompactString::operator!=(const CompactString &other) const noexcept {
+        return !equals(other);
+    }
+
+    bool CompactString::operator>(const CompactString &other) const noexcept {
+        return compare(other) > 0;
+    }
+
+    bool CompactString::operator>=(const CompactString &other) const noexcept {
+        return compare(other) >= 0;
+    }
+
+    bool CompactString::operator<(const CompactString &other) const noexcept {
+        return compare(other) < 0;
+    }
+
+    bool CompactString::operator<=(const CompactString &other) const noexcept {
+        return compare(other) <= 0;
+    }
+
+    std::strong_ordering CompactString::operator<=>(const CompactString &other) const noexcept {
+        return compare(other) <=> 0;
+    }
+
+    std::ostream &operator<<(std::ostream &out, const CompactString &string) {
+        return output::write_formatted(out, string.length_, [&string](std::streambuf &buffer) {
+            return with_code_units(static_cast<const void *>(string.buffer_), string.width_, [&](auto units) {
+                return output::write(buffer, units, string.length_);
+            });
+        });
+    }
+
+    std::wostream &operator<<(std::wostream &out, const CompactString &string) {
+        return output::write_formatted(out, string.length_, [&string](std::wstreambuf &buffer) {
+            return with_code_units(static_cast<const void *>(string.buffer_), string.width_, [&](auto units) {
+                return output::write(buffer, units, string.length_);
+            });
+        });
+    }
+}
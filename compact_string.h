@@ -0,0 +1,305 @@
+#ifndef SEM_2_LAB_1_COMPACT_STRING_H
+#define SEM_2_LAB_1_COMPACT_STRING_H
+
+
+#include "simple_string.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <optional>
+#include <compare>
+
+namespace lab {
+
+    /**
+     * @brief String storing its characters using the narrowest width (1, 2 or 4 bytes) which fits all of them
+     *
+     * @note the storage is widened only when a wider character gets written into the string
+     * so it is at least as wide as required by its content (and is exactly as wide after {@link #shrink()})
+     * @note unlike {@link SimpleString} this does not provide references to its characters
+     * as the characters are not stored as {@code wchar_t}
+     */
+    class CompactString {
+    protected:
+
+        /**
+         * @brief Character buffer, its length (in characters of {@code width_}) is at least {@code length_}
+         *
+         * @note stored string is not 0-terminated
+         */
+        void *buffer_;
+
+        /**
+         * @brief Length of allocated {@code buffer_} in characters
+         */
+        size_t capacity_,
+        /**
+         * @brief Length of the meaningful part of {@code buffer_}
+         */
+        length_;
+
+        /**
+         * @brief Number of bytes used to store a single character, one of {@code 1}, {@code 2} or {@code 4}
+         */
+        unsigned char width_;
+
+        /*
+         * Protected constructor
+         */
+
+        /**
+         * @brief Creates a new compact string of given length and width with no extra buffer space
+         *
+         * @param length length of the created string
+         * @param width width of the created string's characters
+         */
+        CompactString(size_t length, unsigned char width);
+
+        /*
+         * Internal methods
+         */
+
+        /**
+         * @brief Checks if the given index is smaller than this string's length otherwise throwin an exception.
+         * @param index index which should be compared with this string's length
+         * @throws {@code std::out_of_range} if the index is greater or equal to this string's length
+         */
+        void check_index(size_t index) const noexcept(false);
+
+        /**
+         * @brief Ensures that this string's capacity is not less than given and its width is not less than given
+         *
+         * @param required_capacity minimal required capacity
+         * @param required_width minimal required width
+         */
+        void ensure_capacity(size_t required_capacity, unsigned char required_width);
+
+        /**
+         * @brief Resizes this string so that it has the new capacity and width
+         *
+         * @param new_capacity capacity of this string which it should have after resizing
+         * @param new_width width of this string which it should have after resizing
+         */
+        void resize_to(size_t new_capacity, unsigned char new_width);
+
+    public:
+
+        /*
+         * Public constructors
+         */
+
+        /**
+         * @brief Creates a new empty string
+         */
+        CompactString();
+
+        /**
+         * @brief Creates a new string based on the given wide-C-string (0-terminated dynamic {@code wchar_t}-array)
+         *
+         * @param wide_c_string original string to be copied into the created one
+         */
+        explicit CompactString(wchar_t const *wide_c_string);
+
+        /**
+         * @brief Creates a new string with the same content as the given simple string
+         *
+         * @param original string whose content should be copied into the created one
+         */
+        explicit CompactString(const SimpleString &original);
+
+        /*
+         * Special constructors
+         */
+
+        /**
+         * @brief Copies the original string into the created one
+         *
+         * @param original string which should be copied into the created one
+         * @note the created string will have no extra buffer space and the narrowest possible width
+         */
+        CompactString(const CompactString &original);
+
+        /**
+         * @brief Moves the original string into the created one
+         *
+         * @param original string which should be moved into the created one
+         */
+        CompactString(CompactString &&original) noexcept;
+
+        /*
+         * Public destructor
+         */
+
+        /**
+         * @brief Destroys this string freeing all dynamically allocated memory (i.e. {@code buffer_})
+         */
+        ~CompactString();
+
+        /*
+         * Constant public methods
+         */
+
+        /**
+         * @brief Gets this string's length
+         *
+         * @return length of this string
+         */
+        [[nodiscard]] size_t length() const noexcept;
+
+        /**
+         * @brief Checks if this string is empty
+         *
+         * @return {@code true} if this string is empty and {@code} false otherwise
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Gets the number of bytes used to store a single character of this string
+         *
+         * @return {@code 1}, {@code 2} or {@code 4}
+         */
+        [[nodiscard]] unsigned char width() const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the given wide character
+         *
+         * @param character wide character to find
+         * @return optional of wide character's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> index_of(wchar_t character) const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the given character
+         *
+         * @param character character to find
+         * @return optional of character's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> index_of(char character) const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the given string
+         *
+         * @param other string to find
+         * @return optional of string's index if it was found or an empty optional otherwise
+         * @note the strings are searched in their own widths by Two-Way algorithm so the search is linear
+         */
+        [[nodiscard]] std::optional<size_t> index_of(const CompactString &other) const noexcept;
+
+        /**
+         * @brief Gets the character at the given index.
+         *
+         * @param index index at which to get the character
+         * @return character at the given index
+         * @throws {@code std::out_of_range} if the index is greater or equal to this string's length
+         */
+        [[nodiscard]] wchar_t at(size_t index) const noexcept(false);
+
+        /**
+         * @brief Checks is this string is equal to the given.
+         *
+         * @param other string to compare with
+         * @return {@code true} if the strings are equal and {@code false} otherwise
+         * @note this compares string's content thus allowing strings
+         * with different internal data (e.g. {@code capacity} or {@code width}) be equal
+         */
+        [[nodiscard]] bool equals(const CompactString &other) const noexcept;
+
+        /**
+         * @brief Compares this string with the given one.
+         *
+         * @param other string to compare this one with
+         * @return the same as {@link SimpleString#compare(const SimpleString &)} would
+         * @note this compares string's content thus allowing strings
+         * with different internal data (e.g. {@code capacity} or {@code width}) be equal
+         */
+        [[nodiscard]] int compare(const CompactString &other) const noexcept;
+
+        /**
+         * @brief Creates a simple string with the same content as this one
+         *
+         * @return created simple string
+         */
+        [[nodiscard]] SimpleString to_simple_string() const;
+
+        /*
+         * Modifying public methods
+         */
+
+        /**
+         * @brief Shrinks this string so that its buffer has no extra space and its width is the narrowest possible.
+         */
+        void shrink();
+
+        /**
+         * @brief Appends a wide character to this string widening it if needed
+         *
+         * @param character wide character which should be appended to this string
+         */
+        void append(wchar_t character);
+
+        /**
+         * @brief Appends a character to this string
+         *
+         * @param character character which should be appended to this string
+         */
+        void append(char character);
+
+        /**
+         * @brief Appends a string to this string widening it if needed
+         *
+         * @param other string which should be appended to this string
+         */
+        void append(const CompactString &other);
+
+        /**
+         * @brief Sets the character at the given index widening this string if needed.
+         *
+         * @param index index at which to set the character
+         * @param character character to be set at the given index
+         */
+        void set(size_t index, wchar_t character);
+
+        /*
+         * Special operators
+         */
+
+        CompactString &operator=(const CompactString &original);
+
+        CompactString &operator=(CompactString &&original) noexcept;
+
+        /*
+         * Indexed access operators
+         */
+
+        wchar_t operator[](size_t index) const noexcept(false);
+
+        /*
+         * Comparison operators
+         */
+
+        [[nodiscard]] bool operator==(const CompactString &other) const noexcept;
+
+        [[nodiscard]] bool operator!=(const CompactString &other) const noexcept;
+
+        [[nodiscard]] bool operator>(const CompactString &other) const noexcept;
+
+        [[nodiscard]] bool operator>=(const CompactString &other) const noexcept;
+
+        [[nodiscard]] bool operator<(const CompactString &other) const noexcept;
+
+        [[nodiscard]] bool operator<=(const CompactString &other) const noexcept;
+
+        [[nodiscard]] std::strong_ordering operator<=>(const CompactString &other) const noexcept;
+
+        /*
+         * Non-instance operator overloads
+         */
+
+        friend std::ostream &operator<<(std::ostream &out, const CompactString &string);
+
+        friend std::wostream &operator<<(std::wostream &out, const CompactString &string);
+    };
+}
+
+#endif //SEM_2_LAB_1_COMPACT_STRING_H
@@ -0,0 +1,407 @@
+#include "simple_string.h"
+#include "test_util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * Differential harness replaying the same operation traces against lab::SimpleString,
+ * std::wstring and std::u32string
+ *
+ * usage:
+ *   simple_string_differential [--scale <factor>] [--rounds <count>]
+ *     checks that all string types produce the same results and reports their throughput
+ *     relative to lab::SimpleString and the peak memory used by their buffers and the containers holding them,
+ *     exits with status 1 if the results differ
+ *
+ * the timings are only meaningful for optimized builds (e.g. -DCMAKE_BUILD_TYPE=Release)
+ */
+
+namespace {
+
+    /*
+     * Memory tracking
+     */
+
+    /**
+     * @brief Memory resource tracking the number of bytes currently allocated and its maximum
+     */
+    class PeakResource : public std::pmr::memory_resource {
+    public:
+        size_t current = 0, peak = 0;
+
+    protected:
+        void *do_allocate(const size_t bytes, const size_t alignment) override {
+            current += bytes;
+            peak = std::max(peak, current);
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *const pointer, const size_t bytes, const size_t alignment) override {
+            current -= bytes;
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    /*
+     * String adapters
+     */
+
+    /**
+     * @brief Operations of {@link lab::SimpleString} used by the workloads
+     */
+    struct SimpleStringAdapter {
+        using string_type = lab::SimpleString;
+
+        static constexpr const char *name = "lab::SimpleString";
+
+        static string_type make(const std::wstring_view text, std::pmr::memory_resource *const resource) {
+            return string_type(lab::SimpleStringView(text.data(), text.size()), resource);
+        }
+
+        static size_t length(const string_type &string) {
+            return string.length();
+        }
+
+        static std::uint32_t at(const string_type &string, const size_t index) {
+            return std::uint32_t(string.data()[index]);
+        }
+
+        static std::optional<size_t> find(const string_type &string, const wchar_t character, const size_t from) {
+            const auto found = lab::SimpleStringView(string).substr(from).index_of(character);
+            return found ? std::optional(*found + from) : std::nullopt;
+        }
+
+        static std::optional<size_t> find(const string_type &string, const string_type &needle, const size_t from) {
+            const auto found = lab::SimpleStringView(string).substr(from).index_of(needle);
+            return found ? std::optional(*found + from) : std::nullopt;
+        }
+
+        static string_type substr(const string_type &string, const size_t start, const size_t length,
+                                  std::pmr::memory_resource *const resource) {
+            return string_type(lab::SimpleStringView(string).substr(start, length), resource);
+        }
+
+        static string_type join(const string_type &first, const string_type &second, const string_type &third,
+                                std::pmr::memory_resource *const resource) {
+            return string_type(first + second + third, resource);
+        }
+
+        static void append(string_type &string, const string_type &other) {
+            string.append(other);
+        }
+    };
+
+    /**
+     * @brief Operations of {@code std::basic_string} used by the workloads
+     */
+    template<typename TChar>
+    struct StandardAdapter {
+        using string_type = std::pmr::basic_string<TChar>;
+
+        static constexpr const char *name = std::is_same_v<TChar, wchar_t> ? "std::wstring" : "std::u32string";
+
+        static string_type make(const std::wstring_view text, std::pmr::memory_resource *const resource) {
+            return string_type(text.begin(), text.end(), resource);
+        }
+
+        static size_t length(const string_type &string) {
+            return string.length();
+        }
+
+        static std::uint32_t at(const string_type &string, const size_t index) {
+            return std::uint32_t(string[index]);
+        }
+
+        static std::optional<size_t> find(const string_type &string, const wchar_t character, const size_t from) {
+            const auto found = string.find(TChar(character), from);
+            return found == string_type::npos ? std::nullopt : std::optional(found);
+        }
+
+        static std::optional<size_t> find(const string_type &string, const string_type &needle, const size_t from) {
+            const auto found = string.find(needle, from);
+            return found == string_type::npos ? std::nullopt : std::optional(found);
+        }
+
+        static string_type substr(const string_type &string, const size_t start, const size_t length,
+                                  std::pmr::memory_resource *const resource) {
+            return string_type(string, start, length, resource);
+        }
+
+        static string_type join(const string_type &first, const string_type &second, const string_type &third,
+                                std::pmr::memory_resource *const resource) {
+            string_type result(resource);
+            result.reserve(first.length() + second.length() + third.length());
+            result.append(first).append(second).append(third);
+            return result;
+        }
+
+        static void append(string_type &string, const string_type &other) {
+            string.append(other);
+        }
+    };
+
+    /*
+     * Workloads
+     */
+
+    /**
+     * @brief Input shared by all string types
+     */
+    struct Corpus {
+        std::vector<std::wstring> log_lines;
+        std::vector<std::wstring> tenants;
+        size_t key_count;
+        std::wstring document;
+        std::vector<std::wstring> needles;
+    };
+
+    Corpus generate(const size_t scale) {
+        std::uint32_t seed = 42;
+        const auto next = [&seed](const std::uint32_t bound) {
+            seed = seed * 1664525u + 1013904223u;
+            return (seed >> 8u) % bound;
+        };
+
+        const wchar_t *const levels[]{L"DEBUG", L"INFO", L"WARN", L"ERROR"};
+        const wchar_t *const users[]{L"alice", L"bob", L"carol", L"dmitry", L"\u00e9milie", L"\u5f20\u4f1f",
+                                     L"zo\u00eb"};
+        const wchar_t *const actions[]{L"login", L"logout", L"search", L"purchase", L"upload"};
+        const wchar_t *const words[]{L"lorem", L"ipsum", L"dolor", L"sit", L"amet", L"consectetur", L"adipiscing",
+                                     L"elit", L"\u0441\u0442\u0440\u043e\u043a\u0430", L"\u6587\u5b57", L"aaaab"};
+
+        Corpus corpus;
+        for (size_t i = 0; i < 20000 * scale; ++i) {
+            corpus.log_lines.push_back(
+                    L"2024-03-" + std::to_wstring(10 + next(20)) + L" 12:" + std::to_wstring(10 + next(50))
+                    + L" [" + levels[next(4)] + L"] user=" + users[next(7)] + L" action=" + actions[next(5)]
+                    + L" latency=" + std::to_wstring(next(5000)) + L"ms"
+            );
+        }
+
+        for (size_t i = 0; i < 64; ++i) corpus.tenants.push_back(L"tenant-" + std::to_wstring(i * 7919 % 1000));
+        corpus.key_count = 50000 * scale;
+
+        while (corpus.document.size() < 1000000 * scale) {
+            corpus.document += words[next(11)];
+            corpus.document += next(12) == 0 ? L'\n' : L' ';
+        }
+        corpus.needles = {L"lorem", L"elit\n", L"consectetur adipiscing", L"\u6587\u5b57", L"aaaab", L"aaaaab",
+                          L"sit amet sit amet", L"\u0441\u0442\u0440\u043e\u043a\u0430 \u6587"};
+
+        return corpus;
+    }
+
+    /**
+     * @brief Values computed by a workload which should be the same for all string types
+     * and the number of operations it has performed
+     */
+    struct Outcome {
+        std::vector<size_t> values;
+        size_t operations = 0;
+    };
+
+    /**
+     * @brief Parses log lines counting the levels and users and summing the latencies
+     */
+    template<typename TAdapter>
+    Outcome parse_logs(const Corpus &corpus, std::pmr::memory_resource *const resource) {
+        using string_type = typename TAdapter::string_type;
+
+        const auto latency_key = TAdapter::make(L"latency=", resource);
+        const auto user_key = TAdapter::make(L"user=", resource);
+        // the containers allocate from the resource as well so that the size of the string objects is counted
+        std::pmr::unordered_map<string_type, size_t> level_counts(resource);
+        std::pmr::unordered_set<string_type> users(resource);
+        size_t total_latency = 0;
+
+        for (const auto &text: corpus.log_lines) {
+            const auto line = TAdapter::make(text, resource);
+
+            const auto level_start = TAdapter::find(line, L'[', 0);
+            const auto level_end = TAdapter::find(line, L']', *level_start);
+            ++level_counts[TAdapter::substr(line, *level_start + 1, *level_end - *level_start - 1, resource)];
+
+            const auto user_start = *TAdapter::find(line, user_key, *level_end) + TAdapter::length(user_key);
+            const auto user_end = TAdapter::find(line, L' ', user_start);
+            users.insert(TAdapter::substr(line, user_start, *user_end - user_start, resource));
+
+            auto position = *TAdapter::find(line, latency_key, *user_end) + TAdapter::length(latency_key);
+            size_t latency = 0;
+            for (; TAdapter::at(line, position) != U'm'; ++position)
+                latency = latency * 10 + TAdapter::at(line, position) - U'0';
+            total_latency += latency;
+        }
+
+        Outcome outcome{{users.size(), total_latency}, corpus.log_lines.size()};
+        for (const auto level: {L"DEBUG", L"INFO", L"WARN", L"ERROR"})
+            outcome.values.push_back(level_counts[TAdapter::make(level, resource)]);
+
+        return outcome;
+    }
+
+    /**
+     * @brief Builds composite keys and deduplicates them in a hash set
+     */
+    template<typename TAdapter>
+    Outcome build_keys(const Corpus &corpus, std::pmr::memory_resource *const resource) {
+        using string_type = typename TAdapter::string_type;
+
+        const auto separator = TAdapter::make(L":user:", resource);
+        std::pmr::vector<string_type> tenants(resource);
+        for (const auto &tenant: corpus.tenants) tenants.push_back(TAdapter::make(tenant, resource));
+
+        std::pmr::unordered_set<string_type> keys(resource);
+        size_t total_length = 0;
+        for (size_t i = 0; i < corpus.key_count; ++i) {
+            const auto id = std::to_wstring(i * 2654435761u % (corpus.key_count / 2));
+            auto key = TAdapter::join(tenants[i % tenants.size()], separator, TAdapter::make(id, resource), resource);
+            total_length += TAdapter::length(key);
+            keys.insert(std::move(key));
+        }
+
+        return {{keys.size(), total_length}, corpus.key_count};
+    }
+
+    /**
+     * @brief Counts the occurrences of the needles (including the overlapping ones) and the lines of the document
+     */
+    template<typename TAdapter>
+    Outcome scan_document(const Corpus &corpus, std::pmr::memory_resource *const resource) {
+        const auto document = TAdapter::make(corpus.document, resource);
+
+        Outcome outcome;
+        for (const auto &text: corpus.needles) {
+            const auto needle = TAdapter::make(text, resource);
+            size_t count = 0;
+            for (auto found = TAdapter::find(document, needle, 0); found;
+                 found = TAdapter::find(document, needle, *found + 1))
+                ++count;
+            outcome.values.push_back(count);
+            outcome.operations += corpus.document.size();
+        }
+
+        size_t lines = 0;
+        for (auto found = TAdapter::find(document, L'\n', 0); found;
+             found = TAdapter::find(document, L'\n', *found + 1))
+            ++lines;
+        outcome.values.push_back(lines);
+        outcome.operations += corpus.document.size();
+
+        return outcome;
+    }
+
+    /*
+     * Measurement
+     */
+
+    struct Measurement {
+        const char *type;
+        Outcome outcome;
+        double seconds;
+        size_t peak_bytes;
+    };
+
+    template<typename TAdapter, typename TWorkload>
+    Measurement measure(const TWorkload &workload, const Corpus &corpus, const size_t rounds) {
+        Measurement measurement{TAdapter::name, {}, 0, 0};
+        for (size_t round = 0; round < rounds; ++round) {
+            PeakResource resource;
+            const auto start = std::chrono::steady_clock::now();
+            measurement.outcome = workload.template operator()<TAdapter>(corpus, &resource);
+            const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (round == 0 || seconds < measurement.seconds) measurement.seconds = seconds;
+            measurement.peak_bytes = resource.peak;
+        }
+
+        return measurement;
+    }
+
+    /**
+     * @brief Runs the workload against all string types checking their results and reporting their performance
+     *
+     * @return {@code true} if all string types have produced the same results
+     */
+    template<typename TWorkload>
+    bool compare(const char *const name, const TWorkload &workload, const Corpus &corpus, const size_t rounds) {
+        const Measurement measurements[]{
+                measure<SimpleStringAdapter>(workload, corpus, rounds),
+                measure<StandardAdapter<wchar_t>>(workload, corpus, rounds),
+                measure<StandardAdapter<char32_t>>(workload, corpus, rounds)
+        };
+
+        const auto &reference = measurements[0];
+        auto consistent = true;
+        for (const auto &measurement: measurements) {
+            ASSERT_EQUALS(reference.outcome.values.size(), measurement.outcome.values.size())
+            ASSERT_EQUALS(reference.outcome.operations, measurement.outcome.operations)
+            consistent &= reference.outcome.values.size() == measurement.outcome.values.size()
+                          && reference.outcome.operations == measurement.outcome.operations;
+            for (size_t i = 0; i < std::min(reference.outcome.values.size(), measurement.outcome.values.size()); ++i) {
+                ASSERT_EQUALS(reference.outcome.values[i], measurement.outcome.values[i])
+                consistent &= reference.outcome.values[i] == measurement.outcome.values[i];
+            }
+        }
+
+        for (const auto &measurement: measurements) {
+            const auto throughput = double(measurement.outcome.operations) / measurement.seconds;
+            std::cout << std::left << std::setw(16) << name << std::setw(20) << measurement.type << std::right
+                      << std::fixed << std::setprecision(2)
+                      << std::setw(12) << measurement.seconds * 1e3 << " ms"
+                      << std::setw(12) << throughput / 1e6 << " Mop/s"
+                      << std::setw(10) << reference.seconds / measurement.seconds << 'x'
+                      << std::setw(12) << double(measurement.peak_bytes) / 1024 << " KiB peak"
+                      << (consistent ? "" : "  MISMATCH") << '\n';
+        }
+
+        return consistent;
+    }
+}
+
+int main(const int argc, char **argv) {
+    size_t scale = 1, rounds = 3;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument(argv[i]);
+        if (i + 1 < argc && argument == "--scale") scale = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+        else if (i + 1 < argc && argument == "--rounds")
+            rounds = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+        else {
+            std::cerr << "usage: simple_string_differential [--scale <factor>] [--rounds <count>]\n";
+            return 2;
+        }
+    }
+
+    const auto corpus = generate(scale);
+    std::cout << "throughput is relative to " << SimpleStringAdapter::name << " (higher is faster)\n";
+
+    auto consistent = compare("log parsing", []<typename TAdapter>(const Corpus &corpus,
+                                                                    std::pmr::memory_resource *const resource) {
+        return parse_logs<TAdapter>(corpus, resource);
+    }, corpus, rounds);
+    consistent &= compare("key building", []<typename TAdapter>(const Corpus &corpus,
+                                                                 std::pmr::memory_resource *const resource) {
+        return build_keys<TAdapter>(corpus, resource);
+    }, corpus, rounds);
+    consistent &= compare("search scan", []<typename TAdapter>(const Corpus &corpus,
+                                                                std::pmr::memory_resource *const resource) {
+        return scan_document<TAdapter>(corpus, resource);
+    }, corpus, rounds);
+
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include "instrumentation.h"
+#include "thread_counters.h"
+
+#include <iterator>
+#include <mutex>
+
+namespace lab::instrumentation {
+
+    /*
+     * Internal types
+     */
+
+    static constexpr Event events[]{
+            Event::ALLOCATION, Event::DEALLOCATION, Event::REALLOCATION, Event::GROWTH,
+            Event::COPY, Event::CONCATENATION, Event::REPETITION
+    };
+
+    static constexpr size_t event_count = std::size(events);
+
+    template<typename TCounters>
+    static auto &tally_of(TCounters &counters, const Event event) noexcept {
+        switch (event) {
+            case Event::ALLOCATION: return counters.allocations;
+            case Event::DEALLOCATION: return counters.deallocations;
+            case Event::REALLOCATION: return counters.reallocations;
+            case Event::GROWTH: return counters.growths;
+            case Event::COPY: return counters.copies;
+            case Event::CONCATENATION: return counters.concatenations;
+            case Event::REPETITION: break;
+        }
+
+        return counters.repetitions;
+    }
+
+    static const char *name_of(const Event event) noexcept {
+        switch (event) {
+            case Event::ALLOCATION: return "allocations";
+            case Event::DEALLOCATION: return "deallocations";
+            case Event::REALLOCATION: return "reallocations";
+            case Event::GROWTH: return "growths";
+            case Event::COPY: return "copies";
+            case Event::CONCATENATION: return "concatenations";
+            case Event::REPETITION: break;
+        }
+
+        return "repetitions";
+    }
+
+    struct ThreadCounters {
+        thread_counters::Counter counts[event_count], bytes[event_count];
+
+        void retire() noexcept {}
+
+        void add_to(Counters &counters) const noexcept {
+            for (const auto event: events) {
+                auto &tally = tally_of(counters, event);
+                tally.count += counts[size_t(event)].get();
+                tally.bytes += bytes[size_t(event)].get();
+            }
+        }
+    };
+
+    /**
+     * @brief Registry of the threads' counters, late events of a finished thread go directly to its totals
+     */
+    using Registry = thread_counters::Registry<ThreadCounters, Counters>;
+
+    /**
+     * @brief Totals at the last reset which are subtracted from the snapshots
+     *
+     * @note resetting does not touch the counters (which are written by their threads without synchronization)
+     * but remembers their values
+     */
+    static Counters baseline{};
+
+    /**
+     * @brief Mutex guarding the baseline, it is held while the totals are computed so that they are not reset meanwhile
+     */
+    static std::mutex baseline_mutex;
+
+    /*
+     * Public functions
+     */
+
+    void record_event(const Event event, const size_t bytes) noexcept {
+        if (Registry::finished()) {
+            Registry::update_retired([event, bytes](Counters &retired) {
+                auto &tally = tally_of(retired, event);
+                ++tally.count;
+                tally.bytes += bytes;
+            });
+            return;
+        }
+
+        auto &counters = Registry::local();
+        counters.counts[size_t(event)].add(1);
+        counters.bytes[size_t(event)].add(bytes);
+    }
+
+    Counters snapshot() noexcept {
+        const std::lock_guard lock(baseline_mutex);
+
+        auto counters = Registry::total();
+        for (const auto event: events) {
+            auto &tally = tally_of(counters, event);
+            const auto &base = tally_of(baseline, event);
+            tally.count -= base.count;
+            tally.bytes -= base.bytes;
+        }
+
+        return counters;
+    }
+
+    void reset() noexcept {
+        const std::lock_guard lock(baseline_mutex);
+
+        baseline = Registry::total();
+    }
+
+    std::string to_json(const Counters &counters) {
+        std::string json("{");
+        for (const auto event: events) {
+            const auto &tally = tally_of(counters, event);
+            if (json.size() > 1) json += ", ";
+            json += '"';
+            json += name_of(event);
+            json += "\": {\"count\": " + std::to_string(tally.count)
+                    + ", \"bytes\": " + std::to_string(tally.bytes) + '}';
+        }
+        json += '}';
+
+        return json;
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef SEM_2_LAB_1_INSTRUMENTATION_H
+#define SEM_2_LAB_1_INSTRUMENTATION_H
+
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Counters of the memory operations performed by the strings
+ *
+ * @note the counters are opt-in: events are only recorded if {@code LAB_SIMPLE_STRING_INSTRUMENTATION} is defined,
+ * otherwise recording compiles to nothing and all counters stay {@code 0}
+ * @note each thread increments its own counters so recording does not contend between threads
+ */
+namespace lab::instrumentation {
+
+    /**
+     * @brief Whether the events are recorded
+     */
+#ifdef LAB_SIMPLE_STRING_INSTRUMENTATION
+    constexpr bool enabled = true;
+#else
+    constexpr bool enabled = false;
+#endif
+
+    /**
+     * @brief Kind of a recorded event
+     */
+    enum class Event : unsigned char {
+        /**
+         * @brief A heap buffer is allocated, its size in bytes is recorded
+         */
+        ALLOCATION,
+        /**
+         * @brief A heap buffer is freed, its size in bytes is recorded
+         */
+        DEALLOCATION,
+        /**
+         * @brief A buffer is replaced by one of another capacity, the number of moved bytes is recorded
+         */
+        REALLOCATION,
+        /**
+         * @brief A buffer is grown as the characters do not fit into it, the new capacity in bytes is recorded
+         */
+        GROWTH,
+        /**
+         * @brief A string is copied (including the deferred copies of shared buffers), the copied bytes are recorded
+         */
+        COPY,
+        /**
+         * @brief A concatenation is materialized, the written bytes are recorded
+         */
+        CONCATENATION,
+        /**
+         * @brief A repetition is materialized, the written bytes are recorded
+         */
+        REPETITION
+    };
+
+    /**
+     * @brief Number of events of a single kind and the total number of bytes they have involved
+     */
+    struct Tally {
+        size_t count = 0;
+        size_t bytes = 0;
+    };
+
+    /**
+     * @brief Counters of all kinds of events
+     */
+    struct Counters {
+        Tally allocations;
+        Tally deallocations;
+        Tally reallocations;
+        Tally growths;
+        Tally copies;
+        Tally concatenations;
+        Tally repetitions;
+    };
+
+    /**
+     * @brief Records the event in the calling thread's counters unconditionally
+     *
+     * @param event kind of the event
+     * @param bytes number of bytes involved in the event
+     * @note {@link #record(Event, size_t)} should be used instead so that nothing is done if the counters are disabled
+     */
+    void record_event(Event event, size_t bytes) noexcept;
+
+    /**
+     * @brief Records the event if the counters are enabled
+     *
+     * @param event kind of the event
+     * @param bytes number of bytes involved in the event
+     */
+    inline void record(const Event event, const size_t bytes) noexcept {
+        if constexpr (enabled) record_event(event, bytes);
+    }
+
+    /**
+     * @brief Gets the counters
+     *
+     * @return counters of all threads (including the finished ones) since the last {@link #reset()}
+     */
+    [[nodiscard]] Counters snapshot() noexcept;
+
+    /**
+     * @brief Makes all counters start over from {@code 0}
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Converts the counters to JSON
+     *
+     * @param counters counters to convert
+     * @return JSON object with a {@code {"count": ..., "bytes": ...}} object per kind of events
+     */
+    [[nodiscard]] std::string to_json(const Counters &counters);
+}
+
+#endif //SEM_2_LAB_1_INSTRUMENTATION_H
@@ -0,0 +1,233 @@
+#include "intern_pool.h"
+#include "simd_kernels.h"
+
+#include <new>
+#include <algorithm>
+
+namespace lab {
+
+    struct InternedString::Entry {
+
+        /**
+         * @brief Hash of the characters
+         */
+        size_t hash;
+
+        /**
+         * @brief Number of characters following this entry
+         */
+        size_t length;
+
+        [[nodiscard]] const wchar_t *characters() const noexcept {
+            return reinterpret_cast<const wchar_t *>(this + 1);
+        }
+    };
+
+    /*
+     * Static functions
+     */
+
+    static_assert(alignof(InternedString::Entry) >= alignof(wchar_t));
+
+    static constexpr size_t initial_slot_count = 64;
+
+    static inline size_t entry_size_of(const size_t length) noexcept {
+        constexpr auto alignment = alignof(InternedString::Entry);
+        const auto size = sizeof(InternedString::Entry) + length * sizeof(wchar_t);
+
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    /*
+     * InternedString
+     */
+
+    InternedString::InternedString(const Entry *const entry) noexcept: entry_(entry) {}
+
+    InternedString::InternedString() noexcept: entry_(nullptr) {}
+
+    size_t InternedString::length() const noexcept {
+        return entry_ == nullptr ? 0 : entry_->length;
+    }
+
+    bool InternedString::empty() const noexcept {
+        return entry_ == nullptr;
+    }
+
+    const wchar_t *InternedString::data() const noexcept {
+        return entry_ == nullptr ? nullptr : entry_->characters();
+    }
+
+    SimpleStringView InternedString::view() const noexcept {
+        return entry_ == nullptr ? SimpleStringView() : SimpleStringView(entry_->characters(), entry_->length);
+    }
+
+    SimpleString InternedString::to_simple_string() const {
+        return SimpleString(view());
+    }
+
+    InternedString::operator SimpleStringView() const noexcept {
+        return view();
+    }
+
+    bool InternedString::operator==(const InternedString &other) const noexcept {
+        return entry_ == other.entry_;
+    }
+
+    bool InternedString::operator!=(const InternedString &other) const noexcept {
+        return entry_ != other.entry_;
+    }
+
+    std::ostream &operator<<(std::ostream &out, const InternedString &string) {
+        return out << string.view();
+    }
+
+    std::wostream &operator<<(std::wostream &out, const InternedString &string) {
+        return out << string.view();
+    }
+
+    /*
+     * InternPool internal methods
+     */
+
+    size_t InternPool::find_slot(const SimpleStringView string, const size_t hash) const noexcept {
+        const auto mask = slots_.size() - 1, length = string.length();
+        const auto data = string.data();
+
+        for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+            const auto entry = slots_[slot];
+            if (entry == nullptr) return slot;
+            if (entry->hash == hash && entry->length == length
+                && simd::mismatch(entry->characters(), data, length) == length)
+                return slot;
+        }
+    }
+
+    void InternPool::grow_table() {
+        std::vector<const InternedString::Entry *> slots(slots_.size() * 2, nullptr);
+        const auto mask = slots.size() - 1;
+
+        for (const auto entry : slots_) {
+            if (entry == nullptr) continue;
+
+            auto slot = entry->hash & mask;
+            while (slots[slot] != nullptr) slot = (slot + 1) & mask;
+            slots[slot] = entry;
+        }
+
+        slots_.swap(slots);
+    }
+
+    const InternedString::Entry *InternPool::store(const SimpleStringView string, const size_t hash) {
+        const auto size = entry_size_of(string.length());
+
+        std::byte *memory;
+        if (size > block_size_ / 4) {
+            // big strings get blocks of their own so that the regular block is not wasted
+            blocks_.emplace_back(new std::byte[size]);
+            memory = blocks_.back().get();
+            statistics_.arena_bytes += size;
+        } else {
+            if (size_t(free_end_ - free_begin_) < size) {
+                blocks_.emplace_back(new std::byte[block_size_]);
+                free_begin_ = blocks_.back().get();
+                free_end_ = free_begin_ + block_size_;
+                statistics_.arena_bytes += block_size_;
+            }
+            memory = free_begin_;
+            free_begin_ += size;
+        }
+
+        const auto entry = new(memory) InternedString::Entry{hash, string.length()};
+        std::copy(string.data(), string.data() + string.length(),
+                  reinterpret_cast<wchar_t *>(entry + 1));
+
+        return entry;
+    }
+
+    /*
+     * InternPool public constructors
+     */
+
+    InternPool::InternPool(const size_t block_size)
+            : block_size_(std::max(block_size, sizeof(InternedString::Entry) * 4)), blocks_(),
+              free_begin_(nullptr), free_end_(nullptr),
+              slots_(initial_slot_count, nullptr), statistics_() {}
+
+    /*
+     * InternPool static methods
+     */
+
+    InternPool &InternPool::global() noexcept {
+        static InternPool pool;
+        return pool;
+    }
+
+    /*
+     * InternPool constant public methods
+     */
+
+    std::optional<InternedString> InternPool::find(const SimpleStringView string) const noexcept {
+        if (string.empty()) return InternedString();
+
+        const auto hash = string.hash();
+        const std::lock_guard lock(mutex_);
+        const auto entry = slots_[find_slot(string, hash)];
+
+        return entry == nullptr ? std::optional<InternedString>() : InternedString(entry);
+    }
+
+    InternPool::Statistics InternPool::statistics() const noexcept {
+        const std::lock_guard lock(mutex_);
+        return statistics_;
+    }
+
+    /*
+     * InternPool modifying public methods
+     */
+
+    InternedString InternPool::intern(const SimpleStringView string) {
+        if (string.empty()) return InternedString();
+
+        const auto hash = string.hash();
+        const auto bytes = string.length() * sizeof(wchar_t);
+        const std::lock_guard lock(mutex_);
+
+        ++statistics_.requests;
+        auto slot = find_slot(string, hash);
+        if (const auto entry = slots_[slot]; entry != nullptr) {
+            statistics_.saved_bytes += bytes;
+            return InternedString(entry);
+        }
+
+        // keep the load factor at most 1/2 so that probe sequences stay short
+        if ((statistics_.entries + 1) * 2 > slots_.size()) {
+            grow_table();
+            slot = find_slot(string, hash);
+        }
+
+        const auto entry = store(string, hash);
+        slots_[slot] = entry;
+        ++statistics_.entries;
+        statistics_.stored_bytes += bytes;
+
+        return InternedString(entry);
+    }
+
+    void InternPool::clear() noexcept {
+        const std::lock_guard lock(mutex_);
+
+        blocks_.clear();
+        free_begin_ = free_end_ = nullptr;
+        std::fill(slots_.begin(), slots_.end(), nullptr);
+        statistics_ = Statistics();
+    }
+
+    /*
+     * Non-member functions
+     */
+
+    InternedString intern(const SimpleStringView string) {
+        return InternPool::global().intern(string);
+    }
+}
@@ -0,0 +1,320 @@
+#ifndef SEM_2_LAB_1_INTERN_POOL_H
+#define SEM_2_LAB_1_INTERN_POOL_H
+
+
+#include "simple_string.h"
+#include "simple_string_view.h"
+
+#include <cstddef>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <ostream>
+#include <optional>
+
+namespace lab {
+
+    class InternPool;
+
+    /**
+     * @brief Handle of a string interned by {@link InternPool}
+     *
+     * @note handles of the same pool are equal if and only if their strings are equal
+     * so they are compared (and hashed) by pointer in constant time
+     * @note the handle is valid only while its pool is alive and not cleared
+     */
+    class InternedString {
+    public:
+
+        /**
+         * @brief Interned string stored in the pool's arena, immediately followed by its characters
+         */
+        struct Entry;
+
+    protected:
+
+        /**
+         * @brief Canonical entry of the string, {@code nullptr} for an empty string
+         */
+        const Entry *entry_;
+
+        /**
+         * @brief Creates a new handle of the given entry
+         *
+         * @param entry canonical entry of the string
+         */
+        explicit InternedString(const Entry *entry) noexcept;
+
+    public:
+
+        /*
+         * Public constructors
+         */
+
+        /**
+         * @brief Creates a new handle of an empty string
+         */
+        InternedString() noexcept;
+
+        /*
+         * Constant public methods
+         */
+
+        /**
+         * @brief Gets this string's length
+         *
+         * @return length of this string
+         */
+        [[nodiscard]] size_t length() const noexcept;
+
+        /**
+         * @brief Checks if this string is empty
+         *
+         * @return {@code true} if this string is empty and {@code} false otherwise
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Gets the pointer to the interned characters
+         *
+         * @return pointer to the first of {@link #length()} characters owned by the pool
+         */
+        [[nodiscard]] const wchar_t *data() const noexcept;
+
+        /**
+         * @brief Gets a view of the interned characters
+         *
+         * @return view of this string's characters
+         */
+        [[nodiscard]] SimpleStringView view() const noexcept;
+
+        /**
+         * @brief Copies the interned characters into a new string
+         *
+         * @return string equal to this one
+         */
+        [[nodiscard]] SimpleString to_simple_string() const;
+
+        /*
+         * Conversion operators
+         */
+
+        operator SimpleStringView() const noexcept; // NOLINT(google-explicit-constructor)
+
+        /*
+         * Comparison operators
+         */
+
+        [[nodiscard]] bool operator==(const InternedString &other) const noexcept;
+
+        [[nodiscard]] bool operator!=(const InternedString &other) const noexcept;
+
+        /*
+         * Non-instance operator overloads
+         */
+
+        friend std::ostream &operator<<(std::ostream &out, const InternedString &string);
+
+        friend std::wostream &operator<<(std::wostream &out, const InternedString &string);
+
+        /*
+         * Friends
+         */
+
+        friend class InternPool;
+
+        friend struct std::hash<InternedString>;
+    };
+
+    /**
+     * @brief Table mapping string contents to canonical instances stored in an arena
+     *
+     * @note each distinct string is stored only once and all of the pool's memory is released at once
+     * when the pool is destroyed or cleared, so a local pool may be used as a scope for temporary keys
+     * @note the methods may be called concurrently
+     */
+    class InternPool {
+    public:
+
+        /**
+         * @brief Statistics of the pool
+         */
+        struct Statistics {
+
+            /**
+             * @brief Number of distinct interned strings
+             */
+            size_t entries;
+
+            /**
+             * @brief Number of {@link InternPool#intern(SimpleStringView)} calls
+             */
+            size_t requests;
+
+            /**
+             * @brief Number of bytes occupied by the interned characters
+             */
+            size_t stored_bytes;
+
+            /**
+             * @brief Number of bytes of characters which were not stored again since they were already interned
+             */
+            size_t saved_bytes;
+
+            /**
+             * @brief Number of bytes allocated for the arena blocks
+             */
+            size_t arena_bytes;
+        };
+
+        /**
+         * @brief Default size of an arena block in bytes
+         */
+        static constexpr size_t default_block_size = 64 * 1024;
+
+    protected:
+
+        /**
+         * @brief Guard of the table and the arena
+         */
+        mutable std::mutex mutex_;
+
+        /**
+         * @brief Size of a regular arena block in bytes
+         */
+        size_t block_size_;
+
+        /**
+         * @brief Arena blocks, the entries are never moved or freed one by one
+         */
+        std::vector<std::unique_ptr<std::byte[]>> blocks_;
+
+        /**
+         * @brief Free part of the last regular arena block
+         */
+        std::byte *free_begin_, *free_end_;
+
+        /**
+         * @brief Open-addressing (linear probing) hash table of the entries, its size is a power of two
+         */
+        std::vector<const InternedString::Entry *> slots_;
+
+        /**
+         * @brief Statistics of this pool
+         */
+        Statistics statistics_;
+
+        /*
+         * Internal methods
+         */
+
+        /**
+         * @brief Finds the slot of the given string
+         *
+         * @param string characters to find
+         * @param hash hash of the characters
+         * @return index of the slot containing the string's entry or of the empty slot where it should be inserted
+         */
+        [[nodiscard]] size_t find_slot(SimpleStringView string, size_t hash) const noexcept;
+
+        /**
+         * @brief Doubles the number of slots rehashing the entries
+         */
+        void grow_table();
+
+        /**
+         * @brief Copies the given string into the arena
+         *
+         * @param string characters to store
+         * @param hash hash of the characters
+         * @return created entry
+         */
+        [[nodiscard]] const InternedString::Entry *store(SimpleStringView string, size_t hash);
+
+    public:
+
+        /*
+         * Public constructors
+         */
+
+        /**
+         * @brief Creates a new empty pool
+         *
+         * @param block_size size of an arena block in bytes, longer strings get blocks of their own
+         */
+        explicit InternPool(size_t block_size = default_block_size);
+
+        InternPool(const InternPool &other) = delete;
+
+        InternPool &operator=(const InternPool &other) = delete;
+
+        /*
+         * Static methods
+         */
+
+        /**
+         * @brief Gets the pool shared by the whole program
+         *
+         * @return global pool which lives until the program ends
+         */
+        [[nodiscard]] static InternPool &global() noexcept;
+
+        /*
+         * Constant public methods
+         */
+
+        /**
+         * @brief Gets the interned instance of the given string if there is one
+         *
+         * @param string characters to find
+         * @return optional of the interned string if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<InternedString> find(SimpleStringView string) const noexcept;
+
+        /**
+         * @brief Gets the statistics of this pool
+         *
+         * @return snapshot of the statistics
+         */
+        [[nodiscard]] Statistics statistics() const noexcept;
+
+        /*
+         * Modifying public methods
+         */
+
+        /**
+         * @brief Gets the interned instance of the given string interning it if it is not yet interned
+         *
+         * @param string characters to intern
+         * @return canonical handle of the string
+         */
+        InternedString intern(SimpleStringView string);
+
+        /**
+         * @brief Releases all interned strings invalidating their handles
+         */
+        void clear() noexcept;
+    };
+
+    /**
+     * @brief Interns the given string in the global pool
+     *
+     * @param string characters to intern
+     * @return canonical handle of the string
+     */
+    InternedString intern(SimpleStringView string);
+}
+
+namespace std {
+
+    template<>
+    struct hash<lab::InternedString> {
+
+        size_t operator()(const lab::InternedString &string) const noexcept {
+            return std::hash<const void *>()(string.entry_);
+        }
+    };
+}
+
+#endif //SEM_2_LAB_1_INTERN_POOL_H
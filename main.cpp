@@ -1,8 +1,30 @@
 #include "simple_string.h"
+#include "simple_string_view.h"
+#include "compact_string.h"
+#include "simd_kernels.h"
+#include "string_search.h"
+#include "multi_search.h"
+#include "string_column.h"
+#include "rope.h"
+#include "intern_pool.h"
+#include "string_hash.h"
+#include "buffer_cache.h"
+#include "instrumentation.h"
+#include "thread_pool.h"
 #include "test_util.h"
 
 #include <iostream>
+#include <atomic>
+#include <iomanip>
+#include <limits>
+#include <ranges>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <memory_resource>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 using lab::String;
 
@@ -189,6 +211,1374 @@ void test_input() {
     ASSERT_EQUALS(String("OMG"), string)
 }
 
+void test_small_string() {
+    String string;
+    for (size_t i = 0; i < String::inline_capacity; ++i) string.append('a');
+    ASSERT_EQUALS(String(String::inline_capacity, L'a'), string)
+
+    // grow out of the inline buffer
+    string.append('b');
+    ASSERT_EQUALS(String("aaaaaaaaaaaaaaaab"), string)
+    string.append(string);
+    ASSERT_EQUALS(String("aaaaaaaaaaaaaaaabaaaaaaaaaaaaaaaab"), string)
+
+    String copy(string);
+    ASSERT_EQUALS(string, copy)
+    String moved(std::move(copy));
+    ASSERT_EQUALS(string, moved)
+    ASSERT_TRUE(copy.empty())
+
+    String small("foo");
+    String moved_small(std::move(small));
+    ASSERT_EQUALS(String("foo"), moved_small)
+    ASSERT_TRUE(small.empty())
+    small.append('x');
+    ASSERT_EQUALS(String("x"), small)
+
+    moved = moved_small;
+    ASSERT_EQUALS(String("foo"), moved)
+    moved_small = std::move(string);
+    ASSERT_EQUALS(String("aaaaaaaaaaaaaaaabaaaaaaaaaaaaaaaab"), moved_small)
+    moved_small = std::move(moved);
+    ASSERT_EQUALS(String("foo"), moved_small)
+
+    String shrunk("bar");
+    for (size_t i = 0; i < String::inline_capacity; ++i) shrunk.append('!');
+    shrunk.shrink();
+    ASSERT_EQUALS(String("bar!!!!!!!!!!!!!!!!"), shrunk)
+}
+
+void test_compact_string() {
+    using lab::CompactString;
+
+    CompactString string(L"foo bar");
+    ASSERT_EQUALS(1, string.width())
+    ASSERT_EQUALS(L'b', string[4])
+    ASSERT_OPTIONAL_EQUALS(4, string.index_of(L'b'))
+    ASSERT_OPTIONAL_EMPTY(string.index_of(L'\u0431'))
+    ASSERT_OPTIONAL_EQUALS(4, string.index_of(CompactString(L"bar")))
+
+    string.append(L'\u0431');
+    ASSERT_EQUALS(2, string.width())
+    ASSERT_EQUALS(L'\u0431', string.at(7))
+    ASSERT_OPTIONAL_EQUALS(7, string.index_of(L'\u0431'))
+    ASSERT_OPTIONAL_EQUALS(4, string.index_of(CompactString(L"bar")))
+    ASSERT_OPTIONAL_EQUALS(4, string.index_of(CompactString(L"bar\u0431")))
+
+    string.set(0, L'\U0001F600');
+    ASSERT_EQUALS(4, string.width())
+    ASSERT_EQUALS(L'\U0001F600', string.at(0))
+    ASSERT_EQUALS(L'o', string.at(1))
+
+    // equality and order do not depend on the width
+    string.set(0, L'f');
+    string.set(7, L'!');
+    ASSERT_EQUALS(4, string.width())
+    ASSERT_TRUE(string == CompactString(L"foo bar!"))
+    ASSERT_TRUE(string < CompactString(L"foo bas!"))
+    ASSERT_TRUE(string > CompactString(L"foo ba!!"))
+    string.shrink();
+    ASSERT_EQUALS(1, string.width())
+    ASSERT_TRUE(string == CompactString(L"foo bar!"))
+
+    ASSERT_EQUALS(String("foo bar!"), string.to_simple_string())
+    ASSERT_TRUE(CompactString(String("foo bar!")) == string)
+
+    // the search is linear on inputs which are quadratic for the naive one, the widths may differ
+    const String haystack = String(20000, L'a') + String(L"abб");
+    const CompactString compact_haystack(haystack);
+    ASSERT_OPTIONAL_EQUALS(19000, compact_haystack.index_of(CompactString(String(1001, L'a') + String(L"bб"))))
+    ASSERT_OPTIONAL_EQUALS(19000, compact_haystack.index_of(CompactString(String(1001, L'a') + String(L"b"))))
+    ASSERT_OPTIONAL_EMPTY(compact_haystack.index_of(CompactString(String(1000, L'a') + String(L"б"))))
+    ASSERT_OPTIONAL_EMPTY(CompactString(String(100, L'a')).index_of(CompactString(String(L"a\U0001F600"))))
+
+    // the order is the same as the one of SimpleString even for values which are not code points
+    const String negative(1, wchar_t(-1)), positive(1, L'a');
+    ASSERT_EQUALS(negative.compare(positive), CompactString(negative).compare(CompactString(positive)))
+
+    // the character search of every width finds characters at any position of the vectors
+    for (const wchar_t filler: {L'a', L'\u0431', L'\U0001F600'}) {
+        for (size_t length = 1; length < 70; ++length) {
+            String characters(length, filler);
+            characters[length - 1] = L'z';
+            const CompactString compact(characters);
+            ASSERT_OPTIONAL_EQUALS(length - 1, compact.index_of(L'z'))
+            ASSERT_OPTIONAL_EMPTY(compact.index_of(L'y'))
+        }
+    }
+
+    // assignment reuses the buffer when it is large and wide enough
+    const CompactString narrow(L"short"), wide(L"\u0431\u0431"), longer(L"longer than the slot is");
+    CompactString slot(L"\U0001F600 long enough slot");
+    slot = narrow;
+    ASSERT_EQUALS(4, slot.width())
+    ASSERT_TRUE(slot == narrow)
+    slot = wide;
+    ASSERT_TRUE(slot == wide)
+    ASSERT_OPTIONAL_EQUALS(0, slot.index_of(L'\u0431'))
+    slot = longer;
+    ASSERT_EQUALS(1, slot.width())
+    ASSERT_TRUE(slot == longer)
+}
+
+void test_simd_kernels() {
+    using lab::simd::InstructionSet;
+
+    const auto detected = lab::simd::detected_instruction_set();
+    for (const auto instruction_set: {InstructionSet::SCALAR, InstructionSet::SSE2,
+                                      InstructionSet::AVX2, InstructionSet::AVX512}) {
+        if (instruction_set > detected) break;
+        ASSERT_TRUE(lab::simd::use_instruction_set(instruction_set) == instruction_set)
+
+        for (size_t length = 0; length < 70; ++length) {
+            String string(length, L'a');
+            ASSERT_OPTIONAL_EMPTY(string.index_of(L'b'))
+            ASSERT_OPTIONAL_EMPTY(string.last_index_of(L'b'))
+            ASSERT_EQUALS(length, string.count(L'a'))
+
+            for (size_t index = 0; index < length; ++index) {
+                String other(string);
+                other[index] = L'b';
+                ASSERT_OPTIONAL_EQUALS(index, other.index_of(L'b'))
+                ASSERT_OPTIONAL_EQUALS(index, other.last_index_of(L'b'))
+                ASSERT_EQUALS(length - 1, other.count(L'a'))
+                ASSERT_FALSE(string == other)
+                ASSERT_TRUE(string < other)
+                ASSERT_TRUE(other > string)
+            }
+            ASSERT_TRUE(string == String(length, L'a'))
+
+            std::vector<std::uint16_t> units(length, 0x431);
+            ASSERT_EQUALS(length, lab::simd::find_code_unit(units.data(), length, 0x432))
+            for (size_t index = length; index > 0; --index) {
+                units[index - 1] = 0x432;
+                ASSERT_EQUALS(index - 1, lab::simd::find_code_unit(units.data(), length, 0x432))
+            }
+        }
+
+        char narrow[70];
+        wchar_t wide[70];
+        for (size_t i = 0; i < 70; ++i) narrow[i] = char(i * 37);
+        lab::simd::widen(narrow, 70, wide);
+        for (size_t i = 0; i < 70; ++i) ASSERT_EQUALS(wchar_t(narrow[i]), wide[i])
+    }
+    lab::simd::use_instruction_set(detected);
+}
+
+void test_searcher() {
+    using lab::Searcher;
+    using lab::search::Strategy;
+
+    ASSERT_TRUE(Searcher(String("")).strategy() == Strategy::EMPTY)
+    ASSERT_TRUE(Searcher(String("a")).strategy() == Strategy::CHARACTER)
+    ASSERT_TRUE(Searcher(String("ab")).strategy() == Strategy::SHORT)
+    ASSERT_TRUE(Searcher(String(lab::search::short_needle_length + 1, L'a')).strategy() == Strategy::LONG)
+
+    // adversarial input for the naive search
+    const String haystack = String(100000, L'a') + String("b");
+    ASSERT_OPTIONAL_EQUALS(100000 - 999, haystack.index_of(String(999, L'a') + String("b")))
+    ASSERT_OPTIONAL_EQUALS(100000 - 9, haystack.index_of(String(9, L'a') + String("b")))
+    ASSERT_OPTIONAL_EMPTY(haystack.index_of(String("b") + String(999, L'a')))
+
+    // compare with the standard search on small alphabets to get many partial matches
+    std::uint32_t seed = 42;
+    const auto next_character = [&seed](const unsigned alphabet) {
+        seed = seed * 1664525u + 1013904223u;
+        return wchar_t(L'a' + (seed >> 16u) % alphabet);
+    };
+    for (unsigned alphabet = 2; alphabet <= 4; ++alphabet) {
+        for (size_t needle_length = 1; needle_length < 80; needle_length += 3) {
+            std::wstring expected_haystack, expected_needle;
+            String actual_haystack, actual_needle;
+            for (size_t i = 0; i < 2000; ++i) {
+                const auto character = next_character(alphabet);
+                expected_haystack += character;
+                actual_haystack.append(character);
+            }
+            // needle is taken from the haystack so that it is usually found
+            const auto start = (seed >> 8u) % (expected_haystack.length() - needle_length);
+            for (size_t i = 0; i < needle_length; ++i) {
+                const auto character = expected_haystack[start + i];
+                expected_needle += character;
+                actual_needle.append(character);
+            }
+
+            const Searcher searcher(actual_needle);
+            ASSERT_OPTIONAL_EQUALS(expected_haystack.find(expected_needle), searcher.find_in(actual_haystack))
+            ASSERT_OPTIONAL_EQUALS(expected_haystack.find(expected_needle), actual_haystack.index_of(actual_needle))
+
+            actual_needle.append(L'z');
+            ASSERT_OPTIONAL_EMPTY(actual_haystack.index_of(actual_needle))
+        }
+    }
+}
+
+void test_rope() {
+    using lab::Rope;
+
+    Rope rope;
+    std::wstring expected;
+    for (size_t i = 0; i < 2000; ++i) {
+        // pieces longer than the merged chunk length so that they stay separate
+        const String piece = String(Rope::merged_chunk_length / 2 + i % 7, wchar_t(L'a' + i % 26)) + String("|");
+        rope.append(piece);
+        expected.append(Rope::merged_chunk_length / 2 + i % 7, wchar_t(L'a' + i % 26)).append(L"|");
+    }
+    ASSERT_EQUALS(expected.length(), rope.length())
+    ASSERT_TRUE(rope.height() <= 16)
+    for (size_t i = 0; i < expected.length(); i += 997) ASSERT_EQUALS(expected[i], rope[i])
+    ASSERT_THROWS(rope[expected.length()], std::out_of_range)
+
+    const auto flat = rope.flatten();
+    ASSERT_EQUALS(expected.length(), flat.length())
+    ASSERT_EQUALS(expected[expected.length() - 2], flat[expected.length() - 2])
+
+    // matches spanning chunks
+    ASSERT_OPTIONAL_EQUALS(expected.find(L"a|b"), rope.index_of(String("a|b")))
+    ASSERT_OPTIONAL_EQUALS(expected.find(L"z|a"), rope.index_of(String("z|a")))
+    ASSERT_OPTIONAL_EQUALS(expected.find(L'|'), rope.index_of(L'|'))
+    ASSERT_OPTIONAL_EMPTY(rope.index_of(String("a|c")))
+    const auto spanning = expected.substr(5000, 700);
+    ASSERT_OPTIONAL_EQUALS(expected.find(spanning), rope.index_of(String(spanning.c_str())))
+    ASSERT_OPTIONAL_EQUALS(expected.find(L"|" + std::wstring(250, L'c')), rope.index_of(String("|") + String(250, L'c')))
+
+    // slices share chunks but behave as independent ropes
+    const auto slice = rope.substring(1000, 5000);
+    ASSERT_EQUALS(static_cast<size_t>(5000), slice.length())
+    ASSERT_EQUALS(expected[1000], slice[0])
+    ASSERT_EQUALS(expected[5999], slice[4999])
+    ASSERT_TRUE(slice.equals(Rope(String(rope.substring(1000, 5000).flatten()))))
+    ASSERT_TRUE(slice.substring(10, 20) == rope.substring(1010, 20))
+    ASSERT_TRUE(rope.substring(0, 1000) + slice + rope.substring(6000) == rope)
+
+    // small pieces are merged into bigger chunks
+    Rope small;
+    for (size_t i = 0; i < 1000; ++i) small.append(String("ab"));
+    ASSERT_TRUE(small.height() <= 4)
+    ASSERT_OPTIONAL_EQUALS(1, small.index_of(String("ba")))
+    ASSERT_TRUE(small.flatten() == String("ab") * 1000)
+
+    std::stringstream out;
+    out << Rope(String("foo")) + Rope(String("bar"));
+    ASSERT_EQUALS(std::string("foobar"), out.str())
+}
+
+void test_expressions() {
+    const String foo("foo"), bar("bar"), empty;
+
+    ASSERT_EQUALS(String("foobarfoo"), foo + bar + foo)
+    ASSERT_EQUALS(String("foobarfoobar"), (foo + bar) * 2)
+    ASSERT_EQUALS(String("foofoobar"), foo * 2 + bar)
+    ASSERT_EQUALS(String("barfoofoobarfoofoo"), (bar + foo * 2) * 2)
+    ASSERT_EQUALS(String("foo"), foo + empty + empty * 5 + (foo + bar) * 0)
+    ASSERT_EQUALS(static_cast<size_t>(12), (foo + bar * 3).length())
+    ASSERT_THROWS(String(foo * (SIZE_MAX / 2)), std::overflow_error)
+
+    // assigned expressions may refer to the string they are assigned to
+    String string("ab");
+    string = string + String("c");
+    ASSERT_EQUALS(String("abc"), string)
+    string = String("_") + string * 2;
+    ASSERT_EQUALS(String("_abcabc"), string)
+    string = empty + empty;
+    ASSERT_TRUE(string.empty())
+
+    std::stringstream out;
+    out << foo + bar;
+    ASSERT_EQUALS(std::string("foobar"), out.str())
+}
+
+void test_copy_on_write() {
+    const String original(100, L'a');
+
+    String copy(original);
+    if (String::copy_on_write) ASSERT_TRUE(copy.data() == original.data())
+    copy.set(0, L'b');
+    ASSERT_EQUALS(L'a', original[0])
+    ASSERT_EQUALS(L'b', copy[0])
+
+    String appended = original;
+    appended.append('!');
+    ASSERT_EQUALS(static_cast<size_t>(100), original.length())
+    ASSERT_EQUALS(String(100, L'a') + String("!"), appended)
+
+    // the buffer whose character reference was given out is not shared anymore
+    String referenced(original);
+    auto &character = referenced[1];
+    const String referenced_copy(referenced);
+    character = L'c';
+    ASSERT_EQUALS(L'c', referenced[1])
+    ASSERT_EQUALS(L'a', referenced_copy[1])
+    ASSERT_EQUALS(L'a', original[1])
+
+    String assigned("short");
+    assigned = original;
+    ASSERT_EQUALS(original, assigned)
+    assigned = copy;
+    ASSERT_EQUALS(copy, assigned)
+    assigned = String("short");
+    ASSERT_EQUALS(String("short"), assigned)
+
+    // concurrent copies of the same string
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < 4; ++thread) threads.emplace_back([&original] {
+        std::vector<String> copies;
+        for (size_t i = 0; i < 10000; ++i) {
+            copies.push_back(original);
+            if (i % 3 == 0) copies.back().append('x');
+        }
+        for (const auto &element: copies) if (element[99] != L'a') tests::fail("Copy has changed");
+    });
+    for (auto &thread: threads) thread.join();
+    ASSERT_EQUALS(String(100, L'a'), original)
+}
+
+void test_string_view() {
+    using lab::SimpleStringView;
+
+    const String string("key=value; other=thing");
+    const SimpleStringView view = string;
+    ASSERT_EQUALS(string.length(), view.length())
+    ASSERT_TRUE(view.data() == string.data())
+
+    const auto separator = view.index_of(L';').value();
+    const auto first = view.substr(0, separator), second = view.substr(separator + 2);
+    ASSERT_TRUE(first == SimpleStringView(L"key=value"))
+    ASSERT_TRUE(second == SimpleStringView(L"other=thing"))
+    ASSERT_TRUE(first.starts_with(SimpleStringView(L"key=")))
+    ASSERT_TRUE(second.ends_with(SimpleStringView(L"=thing")))
+    ASSERT_FALSE(second.ends_with(view))
+    ASSERT_OPTIONAL_EQUALS(6, second.index_of(SimpleStringView(L"thing")))
+    ASSERT_OPTIONAL_EQUALS(11, string.index_of(second))
+    ASSERT_TRUE(second.substr(6) < first.substr(4))
+    ASSERT_TRUE(first.substr(4, 100) == String("value"))
+    ASSERT_THROWS((void) view.substr(string.length() + 1), std::out_of_range)
+    ASSERT_EQUALS(L'v', first[4])
+    ASSERT_THROWS(first[9], std::out_of_range)
+
+    ASSERT_EQUALS(String("value=thing"), first.substr(4) + second.substr(5))
+    ASSERT_EQUALS(String("key=thing"), String(first.substr(0, 4)) + second.substr(6))
+
+    // appended view may refer to the string itself
+    String appended("abcdefghijklmnop");
+    appended.append(SimpleStringView(appended).substr(10));
+    ASSERT_EQUALS(String("abcdefghijklmnopklmnop"), appended)
+
+    std::stringstream out;
+    out << first << ' ' << second.substr(0, 5);
+    ASSERT_EQUALS(std::string("key=value other"), out.str())
+}
+
+void test_intern_pool() {
+    using lab::InternPool;
+    using lab::InternedString;
+
+    {
+        InternPool pool(256);
+        const String key("customer_id");
+        const auto first = pool.intern(key), second = pool.intern(String(String("customer_") + String("id")));
+        ASSERT_TRUE(first == second)
+        ASSERT_TRUE(first.data() == second.data())
+        ASSERT_TRUE(first.data() != key.data())
+        ASSERT_TRUE(first.view() == key)
+        ASSERT_EQUALS(key, first.to_simple_string())
+
+        const auto other = pool.intern(String("order_id"));
+        ASSERT_TRUE(first != other)
+        ASSERT_TRUE(pool.intern(String()) == InternedString())
+        ASSERT_TRUE(pool.find(String("customer_id")) == first)
+        ASSERT_FALSE(pool.find(String("missing")).has_value())
+
+        // strings longer than a quarter of a block get their own blocks, many small ones need new blocks and rehashing
+        const String big(1000, L'b');
+        ASSERT_TRUE(pool.intern(big).view() == big)
+        std::vector<InternedString> handles;
+        for (int i = 0; i < 1000; ++i) handles.push_back(pool.intern(String(std::to_string(i).c_str())));
+        for (int i = 0; i < 1000; ++i) ASSERT_TRUE(pool.intern(String(std::to_string(i).c_str())) == handles[i])
+        ASSERT_TRUE(pool.find(String("customer_id")) == first)
+
+        const auto statistics = pool.statistics();
+        ASSERT_EQUALS(size_t(1003), statistics.entries)
+        ASSERT_EQUALS(size_t(2004), statistics.requests)
+        // "customer_id" once and all the numbers (10 + 90 * 2 + 900 * 3 characters) once again
+        ASSERT_EQUALS((11 + 2890) * sizeof(wchar_t), statistics.saved_bytes)
+        ASSERT_TRUE(statistics.arena_bytes >= statistics.stored_bytes)
+
+        pool.clear();
+        ASSERT_EQUALS(size_t(0), pool.statistics().entries)
+        ASSERT_FALSE(pool.find(String("customer_id")).has_value())
+    }
+
+    const auto global = lab::intern(String("status"));
+    std::vector<InternedString> results(4);
+    std::vector<std::thread> threads;
+    for (auto &result : results) threads.emplace_back([&result]() { result = lab::intern(String("status")); });
+    for (auto &thread : threads) thread.join();
+    for (const auto &result : results) ASSERT_TRUE(result == global)
+    ASSERT_EQUALS(std::hash<InternedString>()(global), std::hash<InternedString>()(results[0]))
+}
+
+void test_hash() {
+    using lab::SimpleStringView;
+
+    // every length class of the hash function: empty, up to 3 bytes, up to 16 bytes, up to 48 bytes and longer
+    std::unordered_set<size_t> hashes;
+    String string;
+    for (int i = 0; i < 200; ++i) {
+        const String copy(string);
+        ASSERT_EQUALS(string.hash(), copy.hash())
+        ASSERT_EQUALS(string.hash(), SimpleStringView(string).hash())
+        ASSERT_EQUALS(string.hash(), lab::hashing::hash_of(string.data(), string.length()))
+        ASSERT_TRUE(hashes.insert(string.hash()).second)
+        string.append(wchar_t(L'a' + i % 26));
+    }
+    ASSERT_TRUE(lab::hashing::hash_of(string.data(), string.length(), 1) != string.hash())
+
+    // cached hash (if enabled) is forgotten on modification
+    String modified("hash join key");
+    const auto original_hash = modified.hash();
+    modified.append(L'!');
+    ASSERT_TRUE(modified.hash() != original_hash)
+    modified.set(0, L'H');
+    ASSERT_EQUALS(String("Hash join key!").hash(), modified.hash())
+    modified.at(1) = L'A';
+    ASSERT_EQUALS(String("HAsh join key!").hash(), modified.hash())
+    modified = String("hash join key");
+    ASSERT_EQUALS(original_hash, modified.hash())
+
+    // characters written through a reference obtained before hashing are not missed
+    auto &character = modified.at(3);
+    ASSERT_EQUALS(original_hash, modified.hash())
+    character = L'Q';
+    ASSERT_EQUALS(SimpleStringView(modified).hash(), modified.hash())
+    ASSERT_EQUALS(String("hasQ join key").hash(), modified.hash())
+    modified[4] = L'_';
+    const auto escaped_hash = modified.hash();
+    modified[5] = L'J';
+    ASSERT_TRUE(modified.hash() != escaped_hash)
+    modified.append(L'!');
+    ASSERT_EQUALS(String("hasQ_Join key!").hash(), modified.hash())
+
+    std::unordered_map<String, int> counts;
+    for (const auto *word : {"left", "right", "left", "left", "outer"}) ++counts[String(word)];
+    ASSERT_EQUALS(size_t(3), counts.size())
+    ASSERT_EQUALS(3, counts[String("left")])
+    ASSERT_EQUALS(std::hash<SimpleStringView>()(SimpleStringView(L"right")), std::hash<String>()(String("right")))
+}
+
+/**
+ * @brief Memory resource counting the allocations it forwards to the default one
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0, deallocations = 0, allocated_bytes = 0;
+
+protected:
+    void *do_allocate(const size_t bytes, const size_t alignment) override {
+        ++allocations;
+        allocated_bytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *const pointer, const size_t bytes, const size_t alignment) override {
+        ++deallocations;
+        allocated_bytes -= bytes;
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void test_memory_resource() {
+    CountingResource resource, other_resource;
+    {
+        String string(L"a string which does not fit inline", &resource);
+        ASSERT_TRUE(string.resource() == &resource)
+        ASSERT_EQUALS(size_t(1), resource.allocations)
+
+        for (int i = 0; i < 100; ++i) string.append(L'!');
+        ASSERT_TRUE(resource.allocations > 1)
+        ASSERT_EQUALS(resource.allocations - 1, resource.deallocations)
+
+        const String materialized(string + String("tail") + string * 3, &resource);
+        ASSERT_EQUALS(string.length() * 4 + 4, materialized.length())
+        ASSERT_TRUE(materialized.resource() == &resource)
+
+        // copies use the default resource, moves take the resource with them
+        const String copy(string);
+        ASSERT_TRUE(copy.resource() == std::pmr::get_default_resource())
+        ASSERT_EQUALS(string, copy)
+        const auto allocations = resource.allocations;
+        String moved(std::move(string));
+        ASSERT_TRUE(moved.resource() == &resource)
+        ASSERT_EQUALS(allocations, resource.allocations)
+        ASSERT_EQUALS(copy, moved)
+
+        // a buffer of another resource is copied on move assignment
+        String other(String(L"another string which does not fit inline"), &other_resource);
+        other = std::move(moved);
+        ASSERT_TRUE(other.resource() == &other_resource)
+        ASSERT_EQUALS(copy, other)
+        ASSERT_EQUALS(size_t(2), other_resource.allocations)
+        ASSERT_EQUALS(size_t(1), other_resource.deallocations)
+
+        // while a buffer of the same resource is stolen
+        String same(&other_resource);
+        same = std::move(other);
+        ASSERT_EQUALS(size_t(2), other_resource.allocations)
+        ASSERT_EQUALS(copy, same)
+    }
+    ASSERT_EQUALS(resource.allocations, resource.deallocations)
+    ASSERT_EQUALS(size_t(0), resource.allocated_bytes)
+    ASSERT_EQUALS(other_resource.allocations, other_resource.deallocations)
+    ASSERT_EQUALS(size_t(0), other_resource.allocated_bytes)
+
+    // whole request's strings are released at once with the arena
+    std::pmr::monotonic_buffer_resource arena;
+    std::vector<String> strings;
+    for (int i = 0; i < 100; ++i) strings.emplace_back(String(std::to_string(i).c_str()) * 20, &arena);
+    ASSERT_EQUALS(String("99") * 20, strings.back())
+}
+
+void test_buffer_cache() {
+    namespace cache = lab::buffer_cache;
+
+    const auto resource = cache::resource();
+    const auto initial_limits = cache::limits();
+    cache::trim();
+    const auto initial = cache::statistics();
+
+    {
+        // growing a string frees its previous buffers which the next string reuses
+        String first(resource), second(resource);
+        for (int i = 0; i < 1000; ++i) first.append(L'a');
+        for (int i = 0; i < 1000; ++i) second.append(L'b');
+        ASSERT_EQUALS(String(1000, L'a'), first)
+        ASSERT_EQUALS(String(1000, L'b'), second)
+
+        const auto statistics = cache::statistics();
+        ASSERT_TRUE(statistics.hits > initial.hits)
+        ASSERT_TRUE(statistics.misses > initial.misses)
+        ASSERT_TRUE(statistics.cached_bytes > initial.cached_bytes)
+
+        // too big buffers are not cached
+        const String big(cache::max_block_size, L'c', resource);
+        ASSERT_EQUALS(initial.bypasses + 1, cache::statistics().bypasses)
+    }
+
+    cache::trim();
+    ASSERT_EQUALS(initial.cached_bytes, cache::statistics().cached_bytes)
+
+    // nothing is cached beyond the limits
+    cache::set_limits(cache::Limits{2, 1024 * 1024, 4096});
+    {
+        std::vector<String> strings;
+        for (int i = 0; i < 10; ++i) strings.emplace_back(100, L'x', resource);
+    }
+    ASSERT_EQUALS(initial.cached_bytes + 2 * 512, cache::statistics().cached_bytes)
+    cache::set_limits(initial_limits);
+    cache::trim();
+
+    // buffers freed by other threads are cached by them and released when they finish
+    std::vector<String> strings;
+    for (int i = 0; i < 4; ++i) strings.emplace_back(100 * (i + 1), L'y', resource);
+    std::vector<std::thread> threads;
+    for (auto &string : strings)
+        threads.emplace_back([&string, resource]() {
+            string = String(resource);
+            for (int i = 0; i < 100; ++i) string.append(String(1000, L'z', resource));
+        });
+    for (auto &thread : threads) thread.join();
+    for (const auto &string : strings) ASSERT_EQUALS(String(100000, L'z'), string)
+    ASSERT_EQUALS(initial.cached_bytes, cache::statistics().cached_bytes)
+
+    // buffers allocated after the thread's cache is retired still have the size of their class
+    struct LateAllocation {
+        void *&block;
+
+        ~LateAllocation() {
+            block = lab::buffer_cache::resource()->allocate(100, alignof(wchar_t));
+        }
+    };
+    void *late_block = nullptr;
+    std::thread([&late_block, resource]() {
+        // constructed before the cache so that it is destroyed after it
+        thread_local LateAllocation late{late_block};
+        resource->deallocate(resource->allocate(100, alignof(wchar_t)), 100, alignof(wchar_t));
+    }).join();
+    ASSERT_TRUE(late_block != nullptr)
+    resource->deallocate(late_block, 100, alignof(wchar_t));
+    const auto reused = static_cast<unsigned char *>(resource->allocate(128, alignof(wchar_t)));
+    ASSERT_TRUE(reused == late_block)
+    std::fill_n(reused, 128, 0);
+    resource->deallocate(reused, 128, alignof(wchar_t));
+    cache::trim();
+}
+
+/**
+ * @brief Stream buffer without a get area which provides a single character at a time
+ */
+class UnbufferedSource : public std::streambuf {
+    std::string content_;
+    size_t position_ = 0;
+
+public:
+    explicit UnbufferedSource(std::string content) : content_(std::move(content)) {}
+
+protected:
+    int_type underflow() override {
+        return position_ == content_.size() ? traits_type::eof() : traits_type::to_int_type(content_[position_]);
+    }
+
+    int_type uflow() override {
+        return position_ == content_.size() ? traits_type::eof() : traits_type::to_int_type(content_[position_++]);
+    }
+};
+
+void test_bulk_input() {
+    std::stringstream in("first line\r\nsecond\n\n" + std::string(10000, 'x') + "\nlast");
+
+    String word;
+    in >> word;
+    ASSERT_EQUALS(String("first line"), word)
+    in >> word;
+    ASSERT_EQUALS(String("first line"), word)
+    ASSERT_EQUALS('\r', char(in.get()))
+
+    String line;
+    std::vector<String> lines;
+    while (lab::read_line(in, line)) lines.push_back(line);
+    ASSERT_EQUALS(size_t(5), lines.size())
+    ASSERT_EQUALS(String(), lines[0])
+    ASSERT_EQUALS(String("second"), lines[1])
+    ASSERT_EQUALS(String(), lines[2])
+    ASSERT_EQUALS(String(10000, L'x'), lines[3])
+    ASSERT_EQUALS(String("last"), lines[4])
+    ASSERT_TRUE(in.eof())
+
+    // the capacity of the line is reused
+    std::stringstream repeated;
+    for (int i = 0; i < 100; ++i) repeated << std::string(100 - i, char('a' + i % 26)) << ';';
+    lab::read_line(repeated, line, ';');
+    const auto buffer = line.data();
+    for (int i = 1; i < 100; ++i) {
+        lab::read_line(repeated, line, ';');
+        ASSERT_EQUALS(String(size_t(100 - i), wchar_t('a' + i % 26)), line)
+    }
+    ASSERT_TRUE(line.data() == buffer)
+    ASSERT_FALSE(bool(lab::read_line(repeated, line, ';')))
+
+    std::wstringstream wide_in(L"wide\u00e9 line\nnext");
+    String wide;
+    wide_in >> wide;
+    ASSERT_EQUALS(String(L"wide\u00e9 line"), wide)
+    wide_in.get();
+    ASSERT_TRUE(bool(lab::read_line(wide_in, wide)))
+    ASSERT_EQUALS(String("next"), wide)
+
+    UnbufferedSource source("one\ntwo");
+    std::istream unbuffered(&source);
+    String unbuffered_word;
+    unbuffered >> unbuffered_word;
+    ASSERT_EQUALS(String("one"), unbuffered_word)
+    unbuffered.get();
+    ASSERT_TRUE(bool(lab::read_line(unbuffered, unbuffered_word)))
+    ASSERT_EQUALS(String("two"), unbuffered_word)
+    ASSERT_TRUE(unbuffered.eof())
+
+    // narrow streams are decoded from UTF-8 and written back to it
+    const std::string utf8_text = "Привет, été € \U0001D11E";
+    std::stringstream utf8_in(utf8_text + "\n" + utf8_text);
+    String utf8_word;
+    utf8_in >> utf8_word;
+    ASSERT_EQUALS(String(L"Привет, été € \U0001D11E"), utf8_word)
+    utf8_in.get();
+    String utf8_line;
+    ASSERT_TRUE(bool(lab::read_line(utf8_in, utf8_line)))
+    ASSERT_EQUALS(utf8_word, utf8_line)
+    std::ostringstream utf8_out;
+    utf8_out << utf8_word;
+    ASSERT_EQUALS(utf8_text, utf8_out.str())
+
+    // sequences split between the reads of an unbuffered stream are carried over
+    UnbufferedSource split_source(utf8_text);
+    std::istream split_in(&split_source);
+    String split_word;
+    split_in >> split_word;
+    ASSERT_EQUALS(utf8_word, split_word)
+
+    // invalid UTF-8 fails the extraction leaving the string unchanged
+    std::stringstream invalid_in("\xC3\xA9\xFF\n\xE2\x82");
+    String invalid = utf8_word;
+    invalid_in >> invalid;
+    ASSERT_TRUE(invalid_in.fail())
+    ASSERT_EQUALS(utf8_word, invalid)
+    invalid_in.clear();
+    invalid_in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    ASSERT_FALSE(bool(lab::read_line(invalid_in, invalid)))
+    ASSERT_EQUALS(String(), invalid)
+}
+
+void test_encoded_output() {
+    using lab::CompactString;
+    using lab::Rope;
+
+    const String unicode(L"caf\u00e9 \u20ac \U0001F600");
+    std::ostringstream out;
+    out << unicode;
+    ASSERT_EQUALS(std::string("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80"), out.str())
+
+    // characters which are not code points are replaced
+    String invalid;
+    invalid.append(wchar_t(0xD800));
+    invalid.append(wchar_t(0x110000));
+    out.str("");
+    out << invalid;
+    ASSERT_EQUALS(std::string("\xEF\xBF\xBD\xEF\xBF\xBD"), out.str())
+
+    // the width is counted in characters
+    out.str("");
+    out << std::setw(7) << String(L"\u00e9t\u00e9") << '|' << std::left << std::setfill('.') << std::setw(5)
+        << String("ab") << '|' << String("no padding");
+    ASSERT_EQUALS(std::string("    \xC3\xA9t\xC3\xA9|ab...|no padding"), out.str())
+
+    // output bigger than the conversion buffer
+    const String big = String(L"\u00e9") * 3000 + String("x") * 3000;
+    out.str("");
+    out << big;
+    ASSERT_EQUALS(std::string(9000, ' ').size(), out.str().size())
+    ASSERT_TRUE(out.str().compare(6000, 3000, std::string(3000, 'x')) == 0)
+
+    std::wostringstream wide_out;
+    wide_out << std::setw(12) << unicode << big;
+    ASSERT_TRUE(wide_out.str() == L"    caf\u00e9 \u20ac \U0001F600" + std::wstring(3000, L'\u00e9') + std::wstring(3000, L'x'))
+
+    out.str("");
+    out << CompactString(String(L"\u00e9l\u00e8ve")) << ' ' << CompactString(unicode);
+    ASSERT_EQUALS(std::string("\xC3\xA9l\xC3\xA8ve caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80"), out.str())
+
+    out.str("");
+    out << std::right << std::setfill(' ') << std::setw(20) << (Rope(unicode) + Rope(String(L"\u00e9")));
+    ASSERT_EQUALS(std::string("           caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80\xC3\xA9"), out.str())
+}
+
+void test_utf8() {
+    using lab::simd::InstructionSet;
+    using lab::utf8::DecodingError;
+
+    const std::string encoded("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80");
+    const String decoded(L"caf\u00e9 \u20ac \U0001F600");
+    ASSERT_TRUE(String(encoded.c_str()) == decoded)
+    ASSERT_TRUE(String::from_utf8(encoded.data(), encoded.size()) == decoded)
+    ASSERT_EQUALS(encoded, decoded.to_utf8())
+    ASSERT_TRUE(String::from_utf8("a\0b", 3) == String(L"a") + String(1, L'\0') + String(L"b"))
+
+    // the created string has exactly the decoded length
+    const auto from_c_string = String("\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9");
+    ASSERT_EQUALS((size_t) 9, from_c_string.length())
+    ASSERT_TRUE(from_c_string == String(9, L'\u00e9'))
+
+    // the output string's content is replaced
+    std::string out("previous content");
+    String(L"\u00e9").to_utf8(out);
+    ASSERT_EQUALS(std::string("\xC3\xA9"), out)
+    String invalid;
+    invalid.append(wchar_t(0xDFFF));
+    invalid.to_utf8(out);
+    ASSERT_EQUALS(std::string("\xEF\xBF\xBD"), out)
+
+    const auto error_position = [](const std::string &bytes) -> std::optional<size_t> {
+        try {
+            (void) String::from_utf8(bytes.data(), bytes.size());
+        } catch (const DecodingError &e) {
+            return e.position();
+        }
+        return std::nullopt;
+    };
+    ASSERT_OPTIONAL_EMPTY(error_position("abc \xF4\x8F\xBF\xBF"))
+    ASSERT_OPTIONAL_EQUALS((size_t) 3, error_position("abc\x80"))
+    ASSERT_OPTIONAL_EQUALS((size_t) 1, error_position("a\xC0\xAF"))
+    ASSERT_OPTIONAL_EQUALS((size_t) 2, error_position("ab\xE0\x80\xAF"))
+    ASSERT_OPTIONAL_EQUALS((size_t) 0, error_position("\xED\xA0\x80"))
+    ASSERT_OPTIONAL_EQUALS((size_t) 1, error_position("a\xF4\x90\x80\x80"))
+    ASSERT_OPTIONAL_EQUALS((size_t) 2, error_position("\xC3\xA9\xE2\x82"))
+    ASSERT_OPTIONAL_EQUALS((size_t) 0, error_position("\xE2\x82x"))
+    ASSERT_OPTIONAL_EQUALS((size_t) 4, error_position("\xC3\xA9\xD0\xB1\xD0x"))
+    ASSERT_OPTIONAL_EQUALS((size_t) 0, error_position("\xFF"))
+    ASSERT_THROWS((void) String("\xC3"), DecodingError)
+    ASSERT_THROWS((void) String("\xC3"), std::invalid_argument)
+
+    // long inputs mixing ASCII runs of every length with multi-byte characters
+    const auto detected = lab::simd::detected_instruction_set();
+    for (const auto instruction_set: {InstructionSet::SCALAR, InstructionSet::SSE2,
+                                      InstructionSet::AVX2, InstructionSet::AVX512}) {
+        if (instruction_set > detected) break;
+        ASSERT_TRUE(lab::simd::use_instruction_set(instruction_set) == instruction_set)
+
+        std::string bytes;
+        std::wstring expected;
+        for (size_t run = 0; run < 80; ++run) {
+            for (size_t i = 0; i < run; ++i) {
+                bytes += char('a' + i % 26);
+                expected += wchar_t(L'a' + i % 26);
+            }
+            bytes += run % 3 == 0 ? "\xC3\xA9\xD0\xB1" : run % 3 == 1 ? "\xE2\x82\xAC" : "\xF0\x9F\x98\x80";
+            expected += run % 3 == 0 ? L"\u00e9\u0431" : run % 3 == 1 ? L"\u20ac" : L"\U0001F600";
+        }
+        const auto string = String::from_utf8(bytes.data(), bytes.size());
+        ASSERT_EQUALS(expected.size(), string.length())
+        ASSERT_TRUE(string == String(expected.c_str()))
+        ASSERT_EQUALS(bytes, string.to_utf8())
+
+        ASSERT_OPTIONAL_EQUALS(bytes.size(), error_position(bytes + "\xBF"))
+        bytes[bytes.size() / 2 + 1] = '\x80';
+        ASSERT_TRUE(error_position(bytes).has_value())
+    }
+    lab::simd::use_instruction_set(detected);
+}
+
+void test_capacity() {
+    using GrowthPolicy = String::GrowthPolicy;
+
+    CountingResource resource;
+    {
+        String string(&resource);
+        ASSERT_EQUALS(String::inline_capacity, string.capacity())
+        ASSERT_TRUE(string.growth_policy() == String::default_growth_policy)
+
+        string.reserve(1000);
+        ASSERT_EQUALS((size_t) 1000, string.capacity())
+        ASSERT_EQUALS((size_t) 1, resource.allocations)
+        string.reserve(10);
+        ASSERT_EQUALS((size_t) 1000, string.capacity())
+
+        // the reserved buffer is reused by every iteration
+        const String sources[]{String(900, L'a'), String(L"short"), String(1000, L'b'), String(20, L'c')};
+        for (int i = 0; i < 100; ++i) {
+            const auto &source = sources[i % 4];
+            string = source;
+            ASSERT_TRUE(string == source)
+            string.clear();
+            ASSERT_TRUE(string.empty())
+            string.append(source);
+            ASSERT_TRUE(string == source)
+            string = String(L"inline");
+            ASSERT_TRUE(string == String(L"inline"))
+        }
+        ASSERT_EQUALS((size_t) 1000, string.capacity())
+        ASSERT_EQUALS((size_t) 1, resource.allocations)
+
+        // assignment of a longer string allocates exactly its length
+        string = String(1001, L'd');
+        ASSERT_EQUALS((size_t) 1001, string.capacity())
+        ASSERT_EQUALS((size_t) 2, resource.allocations)
+        ASSERT_EQUALS((size_t) 1, resource.deallocations)
+
+        string.clear();
+        string.shrink();
+        ASSERT_EQUALS(String::inline_capacity, string.capacity())
+    }
+    ASSERT_EQUALS(resource.allocations, resource.deallocations)
+
+    const auto grown_capacity = [](const GrowthPolicy growth_policy, const size_t length) {
+        String string;
+        string.set_growth_policy(growth_policy);
+        ASSERT_TRUE(string.growth_policy() == growth_policy)
+        for (size_t i = 0; i < length; ++i) string.append(L'x');
+        ASSERT_EQUALS(length, string.length())
+        const auto capacity = string.capacity();
+
+        // the policy is not copied but it is moved
+        ASSERT_TRUE(String(string).growth_policy() == String::default_growth_policy)
+        ASSERT_TRUE(String(std::move(string)).growth_policy() == growth_policy)
+        return capacity;
+    };
+    ASSERT_EQUALS((size_t) 24, grown_capacity(GrowthPolicy::ONE_AND_A_HALF, 20))
+    ASSERT_EQUALS((size_t) 32, grown_capacity(GrowthPolicy::DOUBLE, 20))
+    ASSERT_EQUALS((size_t) 24, grown_capacity(GrowthPolicy::PAGE_ROUNDED, 20))
+
+    // big buffers fill whole pages
+    String big;
+    big.set_growth_policy(GrowthPolicy::PAGE_ROUNDED);
+    for (size_t i = 0; i < 100000; ++i) {
+        big.append(L'x');
+        if (big.capacity() >= 4096 / sizeof(wchar_t)) {
+            const auto size = big.capacity() * sizeof(wchar_t) + (String::copy_on_write ? sizeof(size_t) : 0);
+            ASSERT_EQUALS((size_t) 0, size % 4096)
+        }
+    }
+    ASSERT_TRUE(big == String(100000, L'x'))
+}
+
+void test_instrumentation() {
+    namespace instrumentation = lab::instrumentation;
+
+    instrumentation::reset();
+    {
+        const String original(100, L'a');
+        const String copy(original);
+        String assigned;
+        assigned = original;
+        const String concatenation = original + copy;
+        const String repetition = original * 3;
+        String grown;
+        for (int i = 0; i < 100; ++i) grown.append(L'b');
+        std::thread([&original]() {
+            CountingResource resource;
+            const String copy_in_thread(original, &resource);
+        }).join();
+    }
+    const auto counters = instrumentation::snapshot();
+
+    if constexpr (instrumentation::enabled) {
+        const auto size = 100 * sizeof(wchar_t);
+        // copy-on-write makes both copies share the original's buffer, only the one with another resource is copied
+        const auto copies = String::copy_on_write ? (size_t) 1 : (size_t) 3;
+        ASSERT_EQUALS(copies, counters.copies.count)
+        ASSERT_EQUALS(copies * size, counters.copies.bytes)
+        ASSERT_EQUALS((size_t) 1, counters.concatenations.count)
+        ASSERT_EQUALS(2 * size, counters.concatenations.bytes)
+        ASSERT_EQUALS((size_t) 1, counters.repetitions.count)
+        ASSERT_EQUALS(3 * size, counters.repetitions.bytes)
+        ASSERT_TRUE(counters.growths.count > 0)
+        ASSERT_EQUALS(counters.growths.count, counters.reallocations.count)
+        ASSERT_TRUE(counters.allocations.count > 0)
+        ASSERT_EQUALS(counters.allocations.count, counters.deallocations.count)
+        ASSERT_EQUALS(counters.allocations.bytes, counters.deallocations.bytes)
+    } else {
+        ASSERT_EQUALS((size_t) 0, counters.allocations.count)
+        ASSERT_EQUALS((size_t) 0, counters.copies.bytes)
+    }
+
+    instrumentation::reset();
+    const auto empty = instrumentation::snapshot();
+    ASSERT_EQUALS((size_t) 0, empty.allocations.count)
+    ASSERT_EQUALS((size_t) 0, empty.repetitions.bytes)
+    ASSERT_EQUALS(std::string(
+            "{\"allocations\": {\"count\": 0, \"bytes\": 0}, \"deallocations\": {\"count\": 0, \"bytes\": 0}, "
+            "\"reallocations\": {\"count\": 0, \"bytes\": 0}, \"growths\": {\"count\": 0, \"bytes\": 0}, "
+            "\"copies\": {\"count\": 0, \"bytes\": 0}, \"concatenations\": {\"count\": 0, \"bytes\": 0}, "
+            "\"repetitions\": {\"count\": 0, \"bytes\": 0}}"
+    ), instrumentation::to_json(empty))
+
+    instrumentation::Counters counters_with_values{};
+    counters_with_values.copies = {2, 64};
+    ASSERT_TRUE(instrumentation::to_json(counters_with_values).find("\"copies\": {\"count\": 2, \"bytes\": 64}")
+                != std::string::npos)
+}
+
+void test_thread_pool() {
+    using lab::ThreadPool;
+
+    ThreadPool pool(3);
+    ASSERT_EQUALS((size_t) 4, pool.concurrency())
+
+    std::vector<std::atomic<int>> runs(1000);
+    pool.run(runs.size(), [&runs](const size_t task) { ++runs[task]; });
+    for (const auto &count: runs) ASSERT_EQUALS(1, count.load())
+
+    // tasks may submit tasks to the same pool
+    std::atomic<size_t> nested{0};
+    pool.run(8, [&pool, &nested](const size_t) {
+        pool.run(8, [&nested](const size_t) { ++nested; });
+    });
+    ASSERT_EQUALS((size_t) 64, nested.load())
+
+    // the remaining tasks still run when one of them throws
+    std::atomic<size_t> finished{0};
+    ASSERT_THROWS(pool.run(16, [&finished](const size_t task) {
+        ++finished;
+        if (task == 5) throw std::runtime_error("task failed");
+    }), std::runtime_error)
+    ASSERT_EQUALS((size_t) 16, finished.load())
+
+    ThreadPool sequential(0);
+    ASSERT_EQUALS((size_t) 1, sequential.concurrency())
+    size_t sum = 0;
+    sequential.run(10, [&sum](const size_t task) { sum += task; });
+    ASSERT_EQUALS((size_t) 45, sum)
+
+    ASSERT_TRUE(ThreadPool::global().concurrency() >= 1)
+}
+
+void test_repetition_fill() {
+    // compare with a character-by-character fill for all the shapes of the doubling
+    for (size_t period = 1; period <= 7; ++period) {
+        String pattern;
+        for (size_t i = 0; i < period; ++i) pattern.append(wchar_t(L'a' + i));
+        for (size_t count = 0; count <= 70; ++count) {
+            const String repeated = pattern * count;
+            ASSERT_EQUALS(period * count, repeated.length())
+            for (size_t i = 0; i < repeated.length(); ++i) ASSERT_EQUALS(wchar_t(L'a' + i % period), repeated[i])
+        }
+    }
+
+    // huge results are filled in parallel
+    const auto check = [](const String &pattern, const size_t count) {
+        const String repeated = pattern * count;
+        const auto period = pattern.length();
+        ASSERT_EQUALS(period * count, repeated.length())
+
+        const auto data = repeated.data();
+        auto consistent = true;
+        for (size_t i = 0; i < repeated.length(); ++i) consistent &= data[i] == pattern.data()[i % period];
+        ASSERT_TRUE(consistent)
+    };
+    check(String(L"xyz"), lab::expression::parallel_fill_threshold / 3 + 12345);
+    check(String(L"\u00e9"), lab::expression::parallel_fill_threshold + 1);
+    check(String(L"ab") * 700001, 4);
+    check(String(L"long pattern") + String(3000000, L'-'), 2);
+
+    // the parallel fill does not depend on the number of hardware threads
+    lab::ThreadPool pool(3);
+    for (const size_t period: {(size_t) 1, (size_t) 7, (size_t) 40000, (size_t) 3000000}) {
+        const auto length = (lab::expression::parallel_fill_threshold / period + 3) * period;
+        std::vector<wchar_t> buffer(length);
+        for (size_t i = 0; i < period; ++i) buffer[i] = wchar_t(i % 1000 + 1);
+        lab::expression::fill_periodic(buffer.data(), period, length, pool);
+
+        auto consistent = true;
+        for (size_t i = period; i < length; ++i) consistent &= buffer[i] == buffer[i % period];
+        ASSERT_TRUE(consistent)
+    }
+}
+
+void test_parallel_index_of() {
+    using lab::search::parallel_chunk_length;
+
+    lab::ThreadPool pool(3);
+    const auto find = [&pool](const String &haystack, const String &needle) {
+        lab::search::Pattern pattern;
+        lab::search::compile(pattern, needle.data(), needle.length());
+        return lab::search::find_parallel(pattern, needle.data(), needle.length(),
+                                          haystack.data(), haystack.length(), pool);
+    };
+
+    const auto length = 5 * parallel_chunk_length + 123;
+    String haystack(length, L'a');
+    ASSERT_EQUALS(length, find(haystack, String("b")))
+    ASSERT_EQUALS(length, lab::search::find_character_parallel(haystack.data(), length, L'b', pool))
+
+    // occurrences starting just before a chunk boundary cross it
+    const String needle = String(40, L'a') + String("bc");
+    for (const size_t start: {parallel_chunk_length - 41, parallel_chunk_length - 1, 3 * parallel_chunk_length,
+                              length - needle.length()}) {
+        String crossing = haystack;
+        for (size_t i = 0; i < needle.length(); ++i) crossing[start + i] = needle[i];
+        const auto expected = start + 40;
+        ASSERT_EQUALS(expected, find(crossing, String("bc")))
+        ASSERT_EQUALS(start + 39, find(crossing, String("abc")))
+        ASSERT_EQUALS(expected, lab::search::find_character_parallel(crossing.data(), length, L'b', pool))
+    }
+
+    // the leftmost of the occurrences found in different chunks wins
+    String several = haystack;
+    for (const size_t start: {4 * parallel_chunk_length + 7, parallel_chunk_length + 5, 2 * parallel_chunk_length})
+        several[start] = L'b';
+    ASSERT_EQUALS(parallel_chunk_length + 5, find(several, String("ab")) + 1)
+    ASSERT_EQUALS(parallel_chunk_length + 5,
+                  lab::search::find_character_parallel(several.data(), length, L'b', pool))
+
+    // needles longer than a chunk
+    const String long_needle = String(parallel_chunk_length + 10, L'a') + String("b");
+    ASSERT_EQUALS(3 * parallel_chunk_length - 3, find(several, long_needle))
+
+    // index_of switches to the parallel search at the threshold
+    const auto threshold = lab::search::parallel_threshold();
+    lab::search::set_parallel_threshold(1000);
+    ASSERT_EQUALS((size_t) 1000, lab::search::parallel_threshold())
+    ASSERT_OPTIONAL_EQUALS(parallel_chunk_length + 5, several.index_of(L'b'))
+    ASSERT_OPTIONAL_EQUALS(parallel_chunk_length + 4, several.index_of(String("ab")))
+    ASSERT_OPTIONAL_EQUALS(parallel_chunk_length + 4, lab::SimpleStringView(several).index_of(String("ab")))
+    ASSERT_OPTIONAL_EQUALS(3 * parallel_chunk_length - 3, lab::Searcher(long_needle).find_in(several))
+    ASSERT_OPTIONAL_EMPTY(haystack.index_of(String("ab")))
+    lab::search::set_parallel_threshold(threshold);
+}
+
+void test_multi_searcher() {
+    using lab::MultiSearcher;
+    using lab::MultiMatch;
+
+    const MultiSearcher searcher({String("he"), String("she"), String("his"), String("hers"), String("she")});
+    ASSERT_EQUALS((size_t) 5, searcher.pattern_count())
+    ASSERT_EQUALS(String("his"), searcher.pattern(2))
+    ASSERT_THROWS(static_cast<void>(searcher.pattern(5)), std::out_of_range)
+    ASSERT_THROWS(MultiSearcher({String("a"), String()}), std::invalid_argument)
+
+    // occurrences are ordered by their end, duplicates are reported for each index
+    const std::vector<MultiMatch> expected{{1, 1}, {4, 1}, {0, 2}, {3, 2}, {2, 6}};
+    ASSERT_TRUE(searcher.find_all_in(String("ushershis")) == expected)
+    ASSERT_TRUE(searcher.find_first_in(String("ushershis")) == (MultiMatch{1, 1}))
+    ASSERT_FALSE(searcher.find_first_in(String("nothing")).has_value())
+    ASSERT_TRUE(searcher.find_all_in(String()).empty())
+
+    // characters outside of Latin-1 get their own classes
+    const MultiSearcher wide({String(L"\u043c\u0438\u0440"), String(L"\U0001F600!")});
+    ASSERT_TRUE(wide.find_first_in(String(L"\u043c\u0438 \u043c\u0438\u0440 \U0001F600!"))
+                == (MultiMatch{0, 3}))
+    ASSERT_TRUE(wide.find_all_in(String(L"\U0001F600\U0001F600!")) == (std::vector<MultiMatch>{{1, 1}}))
+
+    // compare with a search of each pattern on a small alphabet to get many overlapping occurrences
+    std::uint32_t seed = 7;
+    const auto next_character = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return wchar_t(L'a' + (seed >> 16u) % 3);
+    };
+    std::vector<String> patterns;
+    for (size_t i = 0; i < 200; ++i) {
+        String pattern;
+        for (size_t j = 0, length = 1 + i % 7; j < length; ++j) pattern.append(next_character());
+        patterns.push_back(pattern);
+    }
+    String text;
+    for (size_t i = 0; i < 3000; ++i) text.append(next_character());
+
+    const MultiSearcher random(patterns);
+    size_t expected_count = 0;
+    for (const auto &pattern: patterns) {
+        for (size_t i = 0; i + pattern.length() <= text.length(); ++i)
+            expected_count += lab::SimpleStringView(text).substr(i, pattern.length()) == pattern;
+    }
+    const auto all = random.find_all_in(text);
+    ASSERT_EQUALS(expected_count, all.size())
+    auto consistent = true;
+    for (const auto &match: all)
+        consistent &= lab::SimpleStringView(text).substr(match.position, patterns[match.pattern].length())
+                      == patterns[match.pattern];
+    ASSERT_TRUE(consistent)
+    size_t counted = 0;
+    random.for_each_match_in(text, [&counted](const MultiMatch &) { ++counted; });
+    ASSERT_EQUALS(expected_count, counted)
+
+    // chunks of a stream give the same occurrences as the whole text
+    for (const size_t chunk_length: {(size_t) 1, (size_t) 5, (size_t) 1000}) {
+        auto stream = random.stream();
+        std::vector<MultiMatch> streamed;
+        for (size_t start = 0; start < text.length(); start += chunk_length) {
+            stream.feed(lab::SimpleStringView(text).substr(start, chunk_length),
+                        [&streamed](const MultiMatch &match) { streamed.push_back(match); });
+        }
+        ASSERT_EQUALS(text.length(), stream.position())
+        ASSERT_TRUE(streamed == all)
+
+        stream.reset();
+        ASSERT_EQUALS((size_t) 0, stream.position())
+    }
+}
+
+void test_find_all() {
+    const String string("abababa, aba");
+    ASSERT_OPTIONAL_EQUALS(2, string.index_of(String("aba"), 1))
+    ASSERT_OPTIONAL_EQUALS(9, string.index_of(String("aba"), 5))
+    ASSERT_OPTIONAL_EMPTY(string.index_of(String("aba"), 10))
+    ASSERT_OPTIONAL_EQUALS(string.length(), string.index_of(String(), string.length()))
+    ASSERT_OPTIONAL_EMPTY(string.index_of(String(), string.length() + 1))
+    ASSERT_OPTIONAL_EQUALS(7, string.index_of(L',', 3))
+    ASSERT_OPTIONAL_EMPTY(string.index_of(L',', 8))
+    ASSERT_OPTIONAL_EMPTY(string.index_of(L'a', 100))
+
+    ASSERT_OPTIONAL_EQUALS(9, string.last_index_of(String("aba")))
+    ASSERT_OPTIONAL_EQUALS(4, string.last_index_of(String("aba,")))
+    ASSERT_OPTIONAL_EQUALS(0, string.last_index_of(string))
+    ASSERT_OPTIONAL_EMPTY(string.last_index_of(String("abc")))
+    ASSERT_OPTIONAL_EQUALS(string.length(), string.last_index_of(String()))
+    ASSERT_OPTIONAL_EQUALS(11, string.last_index_of(L'a'))
+
+    // overlapping occurrences are included
+    const String needle("aba");
+    std::vector<size_t> positions;
+    for (const auto position: string.find_all(needle)) positions.push_back(position);
+    ASSERT_TRUE(positions == (std::vector<size_t>{0, 2, 4, 9}))
+
+    // the range keeps its own copy of a temporary needle, both a short and a heap-allocated one
+    positions.clear();
+    for (const auto position: string.find_all(String("ab"))) positions.push_back(position);
+    ASSERT_TRUE(positions == (std::vector<size_t>{0, 2, 4, 9}))
+    const String long_haystack = String(100, L'x') + String(40, L'y') + String(100, L'x') + String(40, L'y');
+    positions.clear();
+    for (const auto position: long_haystack.find_all(String(String(40, L'y')))) positions.push_back(position);
+    ASSERT_TRUE(positions == (std::vector<size_t>{100, 240}))
+    const auto copied = string.find_all(String("ba"));
+    const auto copy = copied;
+    ASSERT_EQUALS((size_t) 4, copy.count())
+    ASSERT_EQUALS((size_t) 4, string.count(String("aba")))
+    ASSERT_EQUALS((size_t) 6, string.count(String("a")))
+    ASSERT_EQUALS(string.length() + 1, string.count(String()))
+    ASSERT_EQUALS((size_t) 0, string.count(String("abc")))
+    ASSERT_TRUE(string.find_all(String("abc")).begin() == std::default_sentinel)
+
+    static_assert(std::ranges::forward_range<lab::search::Occurrences>);
+    const auto occurrences = lab::SimpleStringView(string).find_all(String("ba"));
+    ASSERT_EQUALS((size_t) 4, (size_t) std::ranges::distance(occurrences))
+    ASSERT_EQUALS((size_t) 3, *std::ranges::next(occurrences.begin()))
+
+    // compare with the standard search on small alphabets to get many overlapping occurrences
+    std::uint32_t seed = 11;
+    const auto next_character = [&seed](const unsigned alphabet) {
+        seed = seed * 1664525u + 1013904223u;
+        return wchar_t(L'a' + (seed >> 16u) % alphabet);
+    };
+    for (unsigned alphabet = 2; alphabet <= 3; ++alphabet) {
+        for (size_t needle_length = 1; needle_length < 50; needle_length += 4) {
+            std::wstring expected_haystack, expected_needle;
+            String haystack, needle;
+            for (size_t i = 0; i < 3000; ++i) {
+                const auto character = next_character(alphabet);
+                expected_haystack += character;
+                haystack.append(character);
+            }
+            for (size_t i = 0; i < needle_length; ++i) {
+                const auto character = next_character(alphabet);
+                expected_needle += character;
+                needle.append(character);
+            }
+
+            std::vector<size_t> expected;
+            for (auto position = expected_haystack.find(expected_needle); position != std::wstring::npos;
+                 position = expected_haystack.find(expected_needle, position + 1))
+                expected.push_back(position);
+
+            std::vector<size_t> actual;
+            for (const auto position: haystack.find_all(needle)) actual.push_back(position);
+            ASSERT_TRUE(expected == actual)
+            ASSERT_EQUALS(expected.size(), haystack.count(needle))
+            if (expected.empty()) ASSERT_OPTIONAL_EMPTY(haystack.last_index_of(needle))
+            else ASSERT_OPTIONAL_EQUALS(expected.back(), haystack.last_index_of(needle))
+        }
+    }
+
+    // adversarial input for the naive backward search
+    const String haystack = String("b") + String(100000, L'a');
+    ASSERT_OPTIONAL_EQUALS(0, haystack.last_index_of(String(String("b") + String(999, L'a'))))
+    ASSERT_OPTIONAL_EMPTY(haystack.last_index_of(String(String(999, L'a') + String("b"))))
+}
+
+void test_split() {
+    using lab::SimpleStringView;
+
+    const auto parts = [](const auto &range) {
+        std::vector<std::wstring> result;
+        for (const auto part: range) result.emplace_back(part.data(), part.length());
+        return result;
+    };
+    using Parts = std::vector<std::wstring>;
+
+    const String record("id,name,,city");
+    ASSERT_TRUE(parts(record.split(L',')) == (Parts{L"id", L"name", L"", L"city"}))
+    const String empty, comma(",");
+    ASSERT_TRUE(parts(empty.split(L',')) == (Parts{L""}))
+    ASSERT_TRUE(parts(comma.split(L',')) == (Parts{L"", L""}))
+    ASSERT_TRUE(parts(record.split(L';')) == (Parts{L"id,name,,city"}))
+
+    // parts refer to the string's buffer
+    const auto first = *record.split(L',').begin();
+    ASSERT_TRUE(first.data() == record.data())
+    ASSERT_EQUALS((size_t) 2, first.length())
+
+    const String separated("a::b:::c::");
+    ASSERT_TRUE(parts(separated.split(String("::"))) == (Parts{L"a", L"b", L":c", L""}))
+    ASSERT_TRUE(parts(separated.split(String())) == (Parts{L"a::b:::c::"}))
+
+    // ranges keep their own copies of temporary delimiters, both a short and a heap-allocated one
+    std::vector<std::wstring> fields;
+    for (const auto field: separated.split(String("::"))) fields.emplace_back(field.data(), field.length());
+    ASSERT_TRUE(fields == (Parts{L"a", L"b", L":c", L""}))
+    const String long_delimiter(40, L'-');
+    const String long_separated = String("x") + long_delimiter + String("y");
+    fields.clear();
+    for (const auto field: long_separated.split(String(long_delimiter))) fields.emplace_back(field.data(), field.length());
+    ASSERT_TRUE(fields == (Parts{L"x", L"y"}))
+
+    const String mixed(L"a b\tc\u2014d  e");
+    fields.clear();
+    for (const auto field: mixed.split_any(String(L" \t\u2014"))) fields.emplace_back(field.data(), field.length());
+    ASSERT_TRUE(fields == (Parts{L"a", L"b", L"c", L"d", L"", L"e"}))
+    ASSERT_TRUE(parts(mixed.split_any(String(L" \t\u2014"))) == (Parts{L"a", L"b", L"c", L"d", L"", L"e"}))
+    ASSERT_TRUE(parts(mixed.split_any(String())) == (Parts{L"a b\tc\u2014d  e"}))
+
+    const String text("first\r\nsecond\n\nlast"), terminated("one\ntwo\n"), newline("\n");
+    ASSERT_TRUE(parts(text.lines()) == (Parts{L"first", L"second", L"", L"last"}))
+    ASSERT_TRUE(parts(terminated.lines()) == (Parts{L"one", L"two"}))
+    ASSERT_TRUE(parts(newline.lines()) == (Parts{L""}))
+    ASSERT_TRUE(parts(empty.lines()).empty())
+
+    static_assert(std::ranges::forward_range<decltype(record.split(L','))>);
+    ASSERT_EQUALS((std::ptrdiff_t) 4, std::ranges::distance(SimpleStringView(record).split(L',')))
+
+    // fields longer than a vector are split by the vectorized search
+    String long_record;
+    Parts expected;
+    for (size_t i = 0; i < 50; ++i) {
+        if (i != 0) long_record.append(L'|');
+        expected.emplace_back(i, wchar_t(L'a' + i % 26));
+        long_record.append(String(i, wchar_t(L'a' + i % 26)));
+    }
+    ASSERT_TRUE(parts(long_record.split(L'|')) == expected)
+}
+
+void test_string_column() {
+    using lab::StringColumn;
+    using lab::SimpleStringView;
+
+    StringColumn column;
+    ASSERT_TRUE(column.empty())
+    column.reserve(4, 32);
+    column.push_back(String("apple"));
+    column.push_back(SimpleStringView(L"banana"));
+    column.push_back(String());
+    column.push_back(String(L"\u044f\u0431\u043b\u043e\u043a\u043e"));
+    ASSERT_EQUALS((size_t) 4, column.size())
+    ASSERT_EQUALS((size_t) 17, column.character_count())
+
+    // all characters are stored one after another
+    ASSERT_TRUE(column[0] == String("apple"))
+    ASSERT_TRUE(column[1].data() == column[0].data() + 5)
+    ASSERT_TRUE(column.at(2).empty())
+    ASSERT_THROWS(static_cast<void>(column.at(4)), std::out_of_range)
+
+    std::vector<std::wstring> strings;
+    for (const auto string: column) strings.emplace_back(string.data(), string.length());
+    ASSERT_TRUE(strings == (std::vector<std::wstring>{L"apple", L"banana", L"", L"\u044f\u0431\u043b\u043e\u043a\u043e"}))
+    static_assert(std::ranges::forward_range<StringColumn>);
+
+    ASSERT_OPTIONAL_EQUALS(1, column.find(String("banana")))
+    ASSERT_OPTIONAL_EQUALS(2, column.find(String()))
+    ASSERT_OPTIONAL_EMPTY(column.find(String("bananas")))
+    ASSERT_TRUE(column.equals(String("apple")) == (std::vector<bool>{true, false, false, false}))
+
+    const auto comparison = column.compare(String("apply"));
+    ASSERT_TRUE(comparison[0] < 0 && comparison[1] > 0 && comparison[2] < 0 && comparison[3] > 0)
+
+    const auto indices = column.index_of(String("an"));
+    ASSERT_OPTIONAL_EMPTY(indices[0])
+    ASSERT_OPTIONAL_EQUALS(1, indices[1])
+    ASSERT_OPTIONAL_EMPTY(indices[2])
+    ASSERT_OPTIONAL_EMPTY(indices[3])
+    ASSERT_OPTIONAL_EQUALS(0, column.index_of(String())[2])
+
+    // a string of the column may be appended while the buffer is reallocated
+    for (size_t i = 0; i < 100; ++i) column.push_back(column[1]);
+    ASSERT_EQUALS((size_t) 104, column.size())
+    ASSERT_TRUE(column[103] == String("banana"))
+    ASSERT_EQUALS((size_t) 617, column.character_count())
+
+    column.clear();
+    ASSERT_TRUE(column.empty())
+    ASSERT_EQUALS((size_t) 0, column.character_count())
+    column.push_back(String("again"));
+    ASSERT_TRUE(column[0] == String("again"))
+
+    // the column allocates only its two buffers from the given resource
+    std::pmr::monotonic_buffer_resource resource;
+    StringColumn pooled(&resource);
+    pooled.reserve(1000, 8000);
+    for (int i = 0; i < 1000; ++i) pooled.push_back(String(std::to_string(i).c_str()));
+    ASSERT_TRUE(pooled[999] == String("999"))
+    ASSERT_OPTIONAL_EQUALS(123, pooled.find(String("123")))
+}
+
 void run_tests() {
     RUN_TEST(test_equality())
     RUN_TEST(test_comparison())
@@ -201,4 +1591,28 @@ void run_tests() {
     RUN_TEST(test_index_of())
     RUN_TEST(test_output())
     RUN_TEST(test_input())
+    RUN_TEST(test_small_string())
+    RUN_TEST(test_compact_string())
+    RUN_TEST(test_simd_kernels())
+    RUN_TEST(test_searcher())
+    RUN_TEST(test_rope())
+    RUN_TEST(test_expressions())
+    RUN_TEST(test_copy_on_write())
+    RUN_TEST(test_string_view())
+    RUN_TEST(test_intern_pool())
+    RUN_TEST(test_hash())
+    RUN_TEST(test_memory_resource())
+    RUN_TEST(test_buffer_cache())
+    RUN_TEST(test_bulk_input())
+    RUN_TEST(test_encoded_output())
+    RUN_TEST(test_utf8())
+    RUN_TEST(test_capacity())
+    RUN_TEST(test_instrumentation())
+    RUN_TEST(test_thread_pool())
+    RUN_TEST(test_repetition_fill())
+    RUN_TEST(test_parallel_index_of())
+    RUN_TEST(test_multi_searcher())
+    RUN_TEST(test_find_all())
+    RUN_TEST(test_split())
+    RUN_TEST(test_string_column())
 }
@@ -0,0 +1,151 @@
+#include "multi_search.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace lab {
+
+    /*
+     * Public constructors
+     */
+
+    MultiSearcher::MultiSearcher(std::vector<SimpleString> patterns) noexcept(false) : patterns_(std::move(patterns)) {
+        // characters are classified first so that the trie can be built directly in the transition table
+        std::vector<bool> narrow_used(narrow_classes_.size());
+        for (const auto &pattern: patterns_) {
+            if (pattern.empty()) throw std::invalid_argument("Patterns should not be empty");
+
+            for (size_t i = 0; i < pattern.length(); ++i) {
+                const auto character = pattern[i];
+                const auto code = static_cast<std::make_unsigned_t<wchar_t>>(character);
+                if (code < narrow_classes_.size()) narrow_used[code] = true;
+                else wide_characters_.push_back(character);
+            }
+        }
+        State next_class = 1;
+        for (size_t code = 0; code < narrow_classes_.size(); ++code)
+            if (narrow_used[code]) narrow_classes_[code] = next_class++;
+        std::sort(wide_characters_.begin(), wide_characters_.end());
+        wide_characters_.erase(std::unique(wide_characters_.begin(), wide_characters_.end()), wide_characters_.end());
+        wide_characters_.shrink_to_fit();
+        wide_class_base_ = next_class;
+        class_count_ = next_class + wide_characters_.size();
+
+        // trie, absent transitions are marked with no_state
+        const auto class_count = class_count_;
+        transitions_.assign(class_count, no_state);
+        std::vector<State> state_of_pattern(patterns_.size());
+        for (size_t index = 0; index < patterns_.size(); ++index) {
+            const auto &pattern = patterns_[index];
+            State state = 0;
+            for (size_t i = 0; i < pattern.length(); ++i) {
+                auto &next = transitions_[state * class_count + class_of(pattern[i])];
+                if (next == no_state) {
+                    next = State(transitions_.size() / class_count);
+                    transitions_.resize(transitions_.size() + class_count, no_state);
+                }
+                // the reference is invalidated by the resize
+                state = transitions_[state * class_count + class_of(pattern[i])];
+            }
+            state_of_pattern[index] = state;
+        }
+        const auto state_count = transitions_.size() / class_count;
+
+        // patterns of each state, in the order of their indices
+        pattern_offsets_.assign(state_count + 1, 0);
+        for (const auto state: state_of_pattern) ++pattern_offsets_[state + 1];
+        for (size_t state = 0; state < state_count; ++state) pattern_offsets_[state + 1] += pattern_offsets_[state];
+        state_patterns_.resize(patterns_.size());
+        {
+            auto positions = pattern_offsets_;
+            for (size_t index = 0; index < patterns_.size(); ++index)
+                state_patterns_[positions[state_of_pattern[index]]++] = State(index);
+        }
+
+        // breadth-first traversal computing suffix links and replacing absent transitions with the DFA ones
+        accepting_.assign(state_count, 0);
+        output_links_.assign(state_count, no_state);
+        std::vector<State> suffix_links(state_count, 0);
+        std::vector<State> queue;
+        queue.reserve(state_count);
+        for (size_t character_class = 0; character_class < class_count; ++character_class) {
+            auto &next = transitions_[character_class];
+            if (next == no_state) next = 0;
+            else queue.push_back(next);
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const auto state = queue[head];
+            const auto suffix = suffix_links[state];
+            const auto has_own = [this](const State other) {
+                return pattern_offsets_[other] != pattern_offsets_[other + 1];
+            };
+            output_links_[state] = has_own(suffix) ? suffix : output_links_[suffix];
+            accepting_[state] = has_own(state) || output_links_[state] != no_state;
+
+            const auto row = transitions_.data() + state * class_count;
+            const auto suffix_row = transitions_.data() + suffix * class_count;
+            for (size_t character_class = 0; character_class < class_count; ++character_class) {
+                if (row[character_class] == no_state) row[character_class] = suffix_row[character_class];
+                else {
+                    suffix_links[row[character_class]] = suffix_row[character_class];
+                    queue.push_back(row[character_class]);
+                }
+            }
+        }
+    }
+
+    /*
+     * Constant public methods
+     */
+
+    size_t MultiSearcher::pattern_count() const noexcept {
+        return patterns_.size();
+    }
+
+    const SimpleString &MultiSearcher::pattern(const size_t index) const noexcept(false) {
+        if (index >= patterns_.size()) throw std::out_of_range("Index " + std::to_string(index) + " exceeds pattern count");
+
+        return patterns_[index];
+    }
+
+    size_t MultiSearcher::state_count() const noexcept {
+        return accepting_.size();
+    }
+
+    std::optional<MultiMatch> MultiSearcher::find_first_in(const SimpleStringView text) const noexcept {
+        std::optional<MultiMatch> first;
+        auto report = [&first](const MultiMatch &match) {
+            first = match;
+            return true;
+        };
+        scan(0, text.data(), text.length(), 0, report);
+
+        return first;
+    }
+
+    std::vector<MultiMatch> MultiSearcher::find_all_in(const SimpleStringView text) const {
+        std::vector<MultiMatch> matches;
+        for_each_match_in(text, [&matches](const MultiMatch &match) { matches.push_back(match); });
+
+        return matches;
+    }
+
+    MultiSearcher::Stream MultiSearcher::stream() const noexcept {
+        return Stream(*this);
+    }
+
+    /*
+     * Stream
+     */
+
+    MultiSearcher::Stream::Stream(const MultiSearcher &searcher) noexcept : searcher_(&searcher) {}
+
+    size_t MultiSearcher::Stream::position() const noexcept {
+        return position_;
+    }
+
+    void MultiSearcher::Stream::reset() noexcept {
+        state_ = 0;
+        position_ = 0;
+    }
+}
@@ -0,0 +1,313 @@
+#ifndef SEM_2_LAB_1_MULTI_SEARCH_H
+#define SEM_2_LAB_1_MULTI_SEARCH_H
+
+
+#include "simple_string.h"
+#include "simple_string_view.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace lab {
+
+    /**
+     * @brief Occurrence of one of the patterns of {@link MultiSearcher}
+     */
+    struct MultiMatch {
+
+        /**
+         * @brief Index of the found pattern in the searcher
+         */
+        size_t pattern;
+
+        /**
+         * @brief Index of the occurrence's first character in the text
+         */
+        size_t position;
+
+        [[nodiscard]] bool operator==(const MultiMatch &other) const noexcept = default;
+    };
+
+    /**
+     * @brief Searcher of many patterns at once based on Aho-Corasick automaton
+     *
+     * @note the automaton is compiled into a dense DFA whose columns are classes of characters
+     * (all characters not occurring in the patterns share a single class) so each text character
+     * costs a single table lookup regardless of the number of patterns
+     */
+    class MultiSearcher {
+    public:
+
+        /**
+         * @brief Type of the automaton's state indices
+         */
+        using State = std::uint32_t;
+
+        class Stream;
+
+    protected:
+
+        /**
+         * @brief Marker of an absent state
+         */
+        static constexpr State no_state = State(-1);
+
+        /**
+         * @brief Patterns to find
+         */
+        std::vector<SimpleString> patterns_;
+
+        /**
+         * @brief Classes of characters below 256, {@code 0} for the ones not occurring in the patterns
+         */
+        std::array<State, 256> narrow_classes_{};
+
+        /**
+         * @brief Sorted characters of at least 256 occurring in the patterns,
+         * the class of the character is its index plus {@code wide_class_base_}
+         */
+        std::vector<wchar_t> wide_characters_;
+
+        /**
+         * @brief Class of the first of {@code wide_characters_}
+         */
+        State wide_class_base_ = 1;
+
+        /**
+         * @brief Number of character classes, i.e. the number of columns of the transition table
+         */
+        size_t class_count_ = 1;
+
+        /**
+         * @brief Transition table of {@code class_count_} transitions per state, the root state is {@code 0}
+         */
+        std::vector<State> transitions_;
+
+        /**
+         * @brief Whether any pattern ends in the state (directly or through its suffix links)
+         */
+        std::vector<unsigned char> accepting_;
+
+        /**
+         * @brief Offsets of the state's own patterns in {@code state_patterns_}, one more than the number of states
+         */
+        std::vector<State> pattern_offsets_;
+
+        /**
+         * @brief Indices of the patterns ending in each of the states
+         */
+        std::vector<State> state_patterns_;
+
+        /**
+         * @brief The nearest state on the state's suffix link chain having its own patterns or {@code no_state}
+         */
+        std::vector<State> output_links_;
+
+        /**
+         * @brief Gets the class of the character
+         *
+         * @param character character of the text
+         * @return column of the transition table
+         */
+        [[nodiscard]] State class_of(wchar_t character) const noexcept {
+            const auto code = static_cast<std::make_unsigned_t<wchar_t>>(character);
+            if (code < narrow_classes_.size()) return narrow_classes_[code];
+
+            const auto found = std::lower_bound(wide_characters_.begin(), wide_characters_.end(), character);
+            return found != wide_characters_.end() && *found == character
+                   ? wide_class_base_ + State(found - wide_characters_.begin()) : 0;
+        }
+
+        /**
+         * @brief Runs the automaton over the characters reporting the occurrences ending in them
+         *
+         * @param state state in which the automaton is before the first character
+         * @param text characters to feed
+         * @param length number of characters to feed
+         * @param offset position of the first character in the whole text
+         * @param on_match function called with each {@link MultiMatch}, it returns {@code true} to stop the scan
+         * @return state in which the automaton is after the last fed character
+         * or {@code no_state} if the scan has been stopped
+         * @note occurrences are reported by their end and the longer ones first for the same end
+         */
+        template<typename TOnMatch>
+        State scan(State state, const wchar_t *const text, const size_t length, const size_t offset,
+                   TOnMatch &on_match) const {
+            const auto transitions = transitions_.data();
+            const auto class_count = class_count_;
+            for (size_t i = 0; i < length; ++i) {
+                state = transitions[state * class_count + class_of(text[i])];
+                if (!accepting_[state]) continue;
+
+                const auto end = offset + i + 1;
+                for (auto output = state; output != no_state; output = output_links_[output]) {
+                    for (auto j = pattern_offsets_[output]; j < pattern_offsets_[output + 1]; ++j) {
+                        const auto pattern = state_patterns_[j];
+                        if (on_match(MultiMatch{pattern, end - patterns_[pattern].length()})) return no_state;
+                    }
+                }
+            }
+
+            return state;
+        }
+
+    public:
+
+        /*
+         * Public constructors
+         */
+
+        /**
+         * @brief Compiles the automaton of the given patterns
+         *
+         * @param patterns non-empty strings to find, they are copied into the searcher
+         * @throws {@code std::invalid_argument} if any of the patterns is empty
+         */
+        explicit MultiSearcher(std::vector<SimpleString> patterns) noexcept(false);
+
+        /*
+         * Constant public methods
+         */
+
+        /**
+         * @brief Gets the number of patterns found by this searcher
+         *
+         * @return number of patterns
+         */
+        [[nodiscard]] size_t pattern_count() const noexcept;
+
+        /**
+         * @brief Gets the pattern at the given index
+         *
+         * @param index index of the pattern
+         * @return pattern at the index
+         * @throws {@code std::out_of_range} if the index is greater or equal to the number of patterns
+         */
+        [[nodiscard]] const SimpleString &pattern(size_t index) const noexcept(false);
+
+        /**
+         * @brief Gets the number of states of the compiled automaton
+         *
+         * @return number of states
+         */
+        [[nodiscard]] size_t state_count() const noexcept;
+
+        /**
+         * @brief Gets the first occurrence of any pattern in the given text
+         *
+         * @param text string to search in
+         * @return optional of the occurrence ending first (the longest one if several end there)
+         * if any was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<MultiMatch> find_first_in(SimpleStringView text) const noexcept;
+
+        /**
+         * @brief Gets all occurrences of the patterns in the given text
+         *
+         * @param text string to search in
+         * @return occurrences ordered by their end, the longer ones first for the same end
+         */
+        [[nodiscard]] std::vector<MultiMatch> find_all_in(SimpleStringView text) const;
+
+        /**
+         * @brief Calls the function with each occurrence of the patterns in the given text without allocating
+         *
+         * @param text string to search in
+         * @param on_match function called with each {@link MultiMatch} in the order of {@link #find_all_in()}
+         */
+        template<typename TOnMatch>
+        void for_each_match_in(const SimpleStringView text, TOnMatch &&on_match) const {
+            auto report = [&on_match](const MultiMatch &match) {
+                on_match(match);
+                return false;
+            };
+            scan(0, text.data(), text.length(), 0, report);
+        }
+
+        /**
+         * @brief Creates a stream searching the text fed to it in chunks
+         *
+         * @return stream positioned at the start of the text
+         * @note the stream refers to this searcher which should outlive it
+         */
+        [[nodiscard]] Stream stream() const noexcept;
+    };
+
+    /**
+     * @brief Incremental search of a text split into chunks, occurrences spanning chunks are found as well
+     */
+    class MultiSearcher::Stream {
+    protected:
+
+        /**
+         * @brief Searcher whose automaton is run
+         */
+        const MultiSearcher *searcher_;
+
+        /**
+         * @brief State of the automaton after the fed characters
+         */
+        State state_ = 0;
+
+        /**
+         * @brief Number of the fed characters
+         */
+        size_t position_ = 0;
+
+    public:
+
+        /*
+         * Public constructors
+         */
+
+        /**
+         * @brief Creates a new stream of the given searcher
+         *
+         * @param searcher searcher whose patterns are found
+         */
+        explicit Stream(const MultiSearcher &searcher) noexcept;
+
+        /*
+         * Constant public methods
+         */
+
+        /**
+         * @brief Gets the number of characters fed to this stream
+         *
+         * @return position of the next chunk in the whole text
+         */
+        [[nodiscard]] size_t position() const noexcept;
+
+        /*
+         * Public methods
+         */
+
+        /**
+         * @brief Feeds the next chunk of the text calling the function with each occurrence ending in it
+         *
+         * @param chunk characters following the ones fed before
+         * @param on_match function called with each {@link MultiMatch} whose position is in the whole text
+         */
+        template<typename TOnMatch>
+        void feed(const SimpleStringView chunk, TOnMatch &&on_match) {
+            auto report = [&on_match](const MultiMatch &match) {
+                on_match(match);
+                return false;
+            };
+            state_ = searcher_->scan(state_, chunk.data(), chunk.length(), position_, report);
+            position_ += chunk.length();
+        }
+
+        /**
+         * @brief Forgets the fed characters so that the next chunk starts a new text
+         */
+        void reset() noexcept;
+    };
+}
+
+#endif //SEM_2_LAB_1_MULTI_SEARCH_H
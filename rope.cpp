@@ -0,0 +1,469 @@
+#include "rope.h"
+#include "simd_kernels.h"
+#include "string_search.h"
+#include "string_output.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace lab {
+
+    struct Rope::Node {
+
+        /**
+         * @brief Number of characters in this node
+         */
+        size_t length;
+
+        /**
+         * @brief Height of this node, {@code 1} for a leaf
+         */
+        size_t height;
+
+        /**
+         * @brief String referred by this leaf, {@code nullptr} for a concatenation
+         */
+        std::shared_ptr<const SimpleString> chunk;
+
+        /**
+         * @brief Index of the first character of {@code chunk} belonging to this leaf
+         */
+        size_t offset;
+
+        /**
+         * @brief Children of this concatenation, {@code nullptr} for a leaf
+         */
+        std::shared_ptr<const Node> left, right;
+
+        [[nodiscard]] bool is_leaf() const noexcept {
+            return chunk != nullptr;
+        }
+
+        [[nodiscard]] const wchar_t *characters() const noexcept {
+            return chunk->buffer_ + offset;
+        }
+    };
+
+    /*
+     * Static functions
+     */
+
+    using NodePointer = std::shared_ptr<const Rope::Node>;
+
+    static inline size_t height_of(const NodePointer &node) noexcept {
+        return node == nullptr ? 0 : node->height;
+    }
+
+    static NodePointer make_leaf(std::shared_ptr<const SimpleString> chunk, const size_t offset, const size_t length) {
+        return std::make_shared<const Rope::Node>(Rope::Node{length, 1, std::move(chunk), offset, nullptr, nullptr});
+    }
+
+    static NodePointer make_leaf(SimpleString &&string) {
+        const auto length = string.length();
+        return make_leaf(std::make_shared<const SimpleString>(std::move(string)), 0, length);
+    }
+
+    /**
+     * @brief Creates a concatenation of two nodes merging them into a single leaf if they are small leaves
+     *
+     * @param left left child
+     * @param right right child
+     * @return created node
+     */
+    static NodePointer make_concatenation(NodePointer left, NodePointer right) {
+        if (left->is_leaf() && right->is_leaf() && left->length + right->length <= Rope::merged_chunk_length) {
+            SimpleString merged(left->length + right->length, L'\0');
+            std::copy(left->characters(), left->characters() + left->length, &merged[0]);
+            std::copy(right->characters(), right->characters() + right->length, &merged[0] + left->length);
+
+            return make_leaf(std::move(merged));
+        }
+
+        const auto length = left->length + right->length, height = std::max(left->height, right->height) + 1;
+        return std::make_shared<const Rope::Node>(Rope::Node{
+                length, height, nullptr, 0, std::move(left), std::move(right)
+        });
+    }
+
+    static NodePointer rotate_left(const NodePointer &node) {
+        const auto &right = node->right;
+        return make_concatenation(make_concatenation(node->left, right->left), right->right);
+    }
+
+    static NodePointer rotate_right(const NodePointer &node) {
+        const auto &left = node->left;
+        return make_concatenation(left->left, make_concatenation(left->right, node->right));
+    }
+
+    /**
+     * @brief Joins the trees whose heights are not balanced making the left one the base
+     *
+     * @param left taller tree
+     * @param right shorter tree
+     * @return balanced tree of their concatenation
+     */
+    static NodePointer join_right(const NodePointer &left, const NodePointer &right) {
+        const auto &left_left = left->left, &left_right = left->right;
+
+        const auto joined = height_of(left_right) <= height_of(right) + 1
+                ? make_concatenation(left_right, right) : join_right(left_right, right);
+
+        if (height_of(joined) <= height_of(left_left) + 1) return make_concatenation(left_left, joined);
+        // the joined part may be leaning left in which case it should be rotated twice
+        if (height_of(joined->left) > height_of(joined->right)) return rotate_left(
+                make_concatenation(left_left, rotate_right(joined))
+        );
+        return rotate_left(make_concatenation(left_left, joined));
+    }
+
+    /**
+     * @brief Joins the trees whose heights are not balanced making the right one the base
+     *
+     * @param left shorter tree
+     * @param right taller tree
+     * @return balanced tree of their concatenation
+     */
+    static NodePointer join_left(const NodePointer &left, const NodePointer &right) {
+        const auto &right_left = right->left, &right_right = right->right;
+
+        const auto joined = height_of(right_left) <= height_of(left) + 1
+                ? make_concatenation(left, right_left) : join_left(left, right_left);
+
+        if (height_of(joined) <= height_of(right_right) + 1) return make_concatenation(joined, right_right);
+        if (height_of(joined->right) > height_of(joined->left)) return rotate_right(
+                make_concatenation(rotate_left(joined), right_right)
+        );
+        return rotate_right(make_concatenation(joined, right_right));
+    }
+
+    /**
+     * @brief Concatenates the trees keeping the result balanced
+     *
+     * @param left left tree
+     * @param right right tree
+     * @return balanced tree of their concatenation
+     * @note this takes time proportional to the difference of the trees' heights
+     */
+    static NodePointer join(const NodePointer &left, const NodePointer &right) {
+        if (left == nullptr) return right;
+        if (right == nullptr) return left;
+
+        const auto left_height = left->height, right_height = right->height;
+        if (left_height > right_height + 1) return join_right(left, right);
+        if (right_height > left_height + 1) return join_left(left, right);
+
+        return make_concatenation(left, right);
+    }
+
+    /**
+     * @brief Gets the part of the tree
+     *
+     * @param node tree to slice
+     * @param start index of the first character of the part
+     * @param length length of the part, {@code start + length} should not exceed the node's length
+     * @return tree of the part
+     */
+    static NodePointer slice(const NodePointer &node, const size_t start, const size_t length) {
+        if (length == 0) return nullptr;
+        if (start == 0 && length == node->length) return node;
+
+        if (node->is_leaf()) return make_leaf(node->chunk, node->offset + start, length);
+
+        const auto left_length = node->left->length;
+        if (start + length <= left_length) return slice(node->left, start, length);
+        if (start >= left_length) return slice(node->right, start - left_length, length);
+
+        return join(
+                slice(node->left, start, left_length - start),
+                slice(node->right, 0, start + length - left_length)
+        );
+    }
+
+    /**
+     * @brief Calls the function for each leaf of the tree from left to right until it returns {@code false}
+     *
+     * @param node tree whose leaves should be visited
+     * @param function function accepting the leaf's characters and length
+     * @return {@code false} if the function has returned {@code false} and {@code true} otherwise
+     */
+    template<typename TFunction>
+    static bool for_each_chunk(const Rope::Node *node, TFunction &&function) {
+        while (node != nullptr) {
+            if (node->is_leaf()) return function(node->characters(), node->length);
+
+            if (!for_each_chunk(node->left.get(), function)) return false;
+            // the right child is visited iteratively to keep recursion depth bounded by the tree's height
+            node = node->right.get();
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Cursor over the chunks of the tree from left to right
+     */
+    class ChunkCursor {
+        std::vector<const Rope::Node *> path_;
+
+        void descend(const Rope::Node *node) {
+            while (node != nullptr && !node->is_leaf()) {
+                path_.push_back(node->right.get());
+                node = node->left.get();
+            }
+            if (node != nullptr) path_.push_back(node);
+        }
+
+    public:
+        explicit ChunkCursor(const Rope::Node *const root) {
+            path_.reserve(root == nullptr ? 0 : root->height);
+            descend(root);
+        }
+
+        /**
+         * @brief Gets the next chunk
+         *
+         * @return next leaf or {@code nullptr} if all of them have been visited
+         */
+        const Rope::Node *next() {
+            if (path_.empty()) return nullptr;
+
+            const auto leaf = path_.back();
+            path_.pop_back();
+            // the pushed nodes are right children which still have to be descended
+            if (!path_.empty() && !path_.back()->is_leaf()) {
+                const auto pending = path_.back();
+                path_.pop_back();
+                descend(pending);
+            }
+
+            return leaf;
+        }
+    };
+
+    /*
+     * Protected constructors
+     */
+
+    Rope::Rope(std::shared_ptr<const Node> root) noexcept: root_(std::move(root)) {}
+
+    /*
+     * Public constructors
+     */
+
+    Rope::Rope() noexcept: root_() {}
+
+    Rope::Rope(const SimpleString &string) : Rope(SimpleString(string)) {}
+
+    Rope::Rope(SimpleString &&string) : root_(string.empty() ? nullptr : make_leaf(std::move(string))) {}
+
+    /*
+     * Constant public methods
+     */
+
+    size_t Rope::length() const noexcept {
+        return root_ == nullptr ? 0 : root_->length;
+    }
+
+    bool Rope::empty() const noexcept {
+        return root_ == nullptr;
+    }
+
+    size_t Rope::height() const noexcept {
+        return height_of(root_);
+    }
+
+    wchar_t Rope::at(size_t index) const noexcept(false) {
+        if (index >= length()) throw std::out_of_range("Index " + std::to_string(index) + " exceeds rope length");
+
+        auto node = root_.get();
+        while (!node->is_leaf()) {
+            const auto left_length = node->left->length;
+            if (index < left_length) node = node->left.get();
+            else {
+                index -= left_length;
+                node = node->right.get();
+            }
+        }
+
+        return node->characters()[index];
+    }
+
+    std::optional<size_t> Rope::index_of(const wchar_t character) const noexcept {
+        std::optional<size_t> result;
+        size_t chunk_start = 0;
+        for_each_chunk(root_.get(), [&](const wchar_t *const characters, const size_t length) {
+            const auto index = simd::find_character(characters, length, character);
+            if (index != length) {
+                result = chunk_start + index;
+                return false;
+            }
+
+            chunk_start += length;
+            return true;
+        });
+
+        return result;
+    }
+
+    std::optional<size_t> Rope::index_of(const SimpleString &other) const {
+        const auto other_length = other.length();
+        if (other_length == 0) return 0;
+        if (other_length > length()) return std::optional<size_t>();
+
+        const auto needle = other.buffer_;
+        search::Pattern pattern;
+        search::compile(pattern, needle, other_length);
+
+        // last `other_length - 1` characters preceding the current chunk as a match can start in them,
+        // the window is reused by all chunks and never holds more than twice as many characters
+        const auto carry_length = other_length - 1;
+        SimpleString window;
+        window.reserve(2 * carry_length);
+
+        std::optional<size_t> result;
+        size_t chunk_start = 0;
+        for_each_chunk(root_.get(), [&](const wchar_t *const characters, const size_t length) {
+            // matches which end in this chunk but start in the previous ones
+            const auto prefix_length = std::min(length, carry_length);
+            const auto carried = window.length();
+            window.append(SimpleStringView(characters, prefix_length));
+
+            auto index = search::find(pattern, needle, other_length, window.buffer_, window.length());
+            if (index != window.length()) {
+                result = chunk_start - carried + index;
+                return false;
+            }
+
+            // matches which are inside this chunk
+            index = search::find(pattern, needle, other_length, characters, length);
+            if (index != length) {
+                result = chunk_start + index;
+                return false;
+            }
+
+            // keep only the characters which can start a match in the following chunks
+            if (length >= carry_length) {
+                window.clear();
+                window.append(SimpleStringView(characters + length - carry_length, carry_length));
+            } else {
+                // the whole chunk has been appended so the window ends with the last characters
+                const auto total = window.length(), kept = std::min(total, carry_length);
+                std::copy(window.buffer_ + total - kept, window.buffer_ + total, window.buffer_);
+                window.truncate(kept);
+            }
+
+            chunk_start += length;
+            return true;
+        });
+
+        return result;
+    }
+
+    Rope Rope::substring(const size_t start, size_t length) const noexcept(false) {
+        const auto own_length = this->length();
+        if (start > own_length) throw std::out_of_range("Index " + std::to_string(start) + " exceeds rope length");
+
+        length = std::min(length, own_length - start);
+        return Rope(root_ == nullptr ? nullptr : slice(root_, start, length));
+    }
+
+    bool Rope::equals(const Rope &other) const noexcept {
+        if (root_ == other.root_) return true;
+        if (length() != other.length()) return false;
+
+        ChunkCursor cursor(root_.get()), other_cursor(other.root_.get());
+        const wchar_t *characters = nullptr, *other_characters = nullptr;
+        size_t remaining = 0, other_remaining = 0;
+        while (true) {
+            if (remaining == 0) {
+                const auto leaf = cursor.next();
+                if (leaf == nullptr) return true;
+                characters = leaf->characters();
+                remaining = leaf->length;
+            }
+            if (other_remaining == 0) {
+                const auto leaf = other_cursor.next();
+                other_characters = leaf->characters();
+                other_remaining = leaf->length;
+            }
+
+            const auto compared = std::min(remaining, other_remaining);
+            if (simd::mismatch(characters, other_characters, compared) != compared) return false;
+
+            characters += compared;
+            other_characters += compared;
+            remaining -= compared;
+            other_remaining -= compared;
+        }
+    }
+
+    SimpleString Rope::flatten() const {
+        SimpleString result(length());
+        auto result_buffer = result.buffer_;
+        for_each_chunk(root_.get(), [&](const wchar_t *const characters, const size_t length) {
+            result_buffer = std::copy(characters, characters + length, result_buffer);
+            return true;
+        });
+
+        return result;
+    }
+
+    /*
+     * Modifying public methods
+     */
+
+    void Rope::append(const Rope &other) {
+        root_ = join(root_, other.root_);
+    }
+
+    void Rope::append(const SimpleString &other) {
+        if (!other.empty()) root_ = join(root_, make_leaf(SimpleString(other)));
+    }
+
+    /*
+     * Indexed access operators
+     */
+
+    wchar_t Rope::operator[](const size_t index) const noexcept(false) {
+        return at(index);
+    }
+
+    /*
+     * Modification operators
+     */
+
+    Rope Rope::operator+(const Rope &other) const {
+        return Rope(join(root_, other.root_));
+    }
+
+    /*
+     * Comparison operators
+     */
+
+    bool Rope::operator==(const Rope &other) const noexcept {
+        return equals(other);
+    }
+
+    bool Rope::operator!=(const Rope &other) const noexcept {
+        return !equals(other);
+    }
+
+    std::ostream &operator<<(std::ostream &out, const Rope &rope) {
+        return output::write_formatted(out, rope.length(), [&rope](std::streambuf &buffer) {
+            return for_each_chunk(rope.root_.get(), [&buffer](const wchar_t *const characters, const size_t length) {
+                return output::write(buffer, characters, length);
+            });
+        });
+    }
+
+    std::wostream &operator<<(std::wostream &out, const Rope &rope) {
+        return output::write_formatted(out, rope.length(), [&rope](std::wstreambuf &buffer) {
+            return for_each_chunk(rope.root_.get(), [&buffer](const wchar_t *const characters, const size_t length) {
+                return output::write(buffer, characters, length);
+            });
+        });
+    }
+}
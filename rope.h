@@ -0,0 +1,202 @@
+#ifndef SEM_2_LAB_1_ROPE_H
+#define SEM_2_LAB_1_ROPE_H
+
+
+#include "simple_string.h"
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <optional>
+
+namespace lab {
+
+    /**
+     * @brief Immutable-chunk string (rope) optimized for concatenation and slicing of big strings
+     *
+     * @note the chunks are stored in a height-balanced (AVL) tree whose nodes are immutable and shared between ropes
+     * so copying a rope, concatenating ropes and slicing a rope never copy the characters
+     * (except for small neighbouring chunks which get merged into one)
+     */
+    class Rope {
+    public:
+
+        /**
+         * @brief Immutable node of the rope's tree, either a leaf referring to a chunk or a concatenation of two nodes
+         */
+        struct Node;
+
+    protected:
+
+        /**
+         * @brief Root of the tree, {@code nullptr} for an empty rope
+         */
+        std::shared_ptr<const Node> root_;
+
+        /*
+         * Protected constructor
+         */
+
+        /**
+         * @brief Creates a new rope with the given tree
+         *
+         * @param root root of the tree
+         */
+        explicit Rope(std::shared_ptr<const Node> root) noexcept;
+
+    public:
+
+        /**
+         * @brief Maximal length of the chunk created by merging two neighbouring chunks on concatenation
+         */
+        static constexpr size_t merged_chunk_length = 512;
+
+        /*
+         * Public constructors
+         */
+
+        /**
+         * @brief Creates a new empty rope
+         */
+        Rope() noexcept;
+
+        /**
+         * @brief Creates a new rope consisting of the given string
+         *
+         * @param string string to be copied into the rope
+         */
+        explicit Rope(const SimpleString &string);
+
+        /**
+         * @brief Creates a new rope consisting of the given string
+         *
+         * @param string string to be moved into the rope
+         */
+        explicit Rope(SimpleString &&string);
+
+        /*
+         * Constant public methods
+         */
+
+        /**
+         * @brief Gets this rope's length
+         *
+         * @return length of this rope
+         */
+        [[nodiscard]] size_t length() const noexcept;
+
+        /**
+         * @brief Checks if this rope is empty
+         *
+         * @return {@code true} if this rope is empty and {@code} false otherwise
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Gets the height of this rope's tree
+         *
+         * @return {@code 0} for an empty rope, {@code 1} for a single chunk and logarithm of the chunk count otherwise
+         */
+        [[nodiscard]] size_t height() const noexcept;
+
+        /**
+         * @brief Gets the character at the given index.
+         *
+         * @param index index at which to get the character
+         * @return character at the given index
+         * @throws {@code std::out_of_range} if the index is greater or equal to this rope's length
+         * @note this takes logarithmic time
+         */
+        [[nodiscard]] wchar_t at(size_t index) const noexcept(false);
+
+        /**
+         * @brief Gets an index of the first occurrence of the given wide character
+         *
+         * @param character wide character to find
+         * @return optional of wide character's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> index_of(wchar_t character) const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the given string including the ones spanning multiple chunks
+         *
+         * @param other string to find
+         * @return optional of string's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> index_of(const SimpleString &other) const;
+
+        /**
+         * @brief Gets a part of this rope.
+         *
+         * @param start index of the first character of the part
+         * @param length length of the part, it is limited by the length of this rope
+         * @return rope sharing the chunks with this one
+         * @throws {@code std::out_of_range} if the start is greater than this rope's length
+         * @note the created rope keeps whole chunks of this one alive
+         */
+        [[nodiscard]] Rope substring(size_t start, size_t length = SIZE_MAX) const noexcept(false);
+
+        /**
+         * @brief Checks is this rope is equal to the given.
+         *
+         * @param other rope to compare with
+         * @return {@code true} if the ropes have the same content and {@code false} otherwise
+         */
+        [[nodiscard]] bool equals(const Rope &other) const noexcept;
+
+        /**
+         * @brief Copies the content of this rope into a single string.
+         *
+         * @return string of this rope's content, it is allocated only once
+         */
+        [[nodiscard]] SimpleString flatten() const;
+
+        /*
+         * Modifying public methods
+         */
+
+        /**
+         * @brief Appends a rope to this rope
+         *
+         * @param other rope which should be appended to this rope
+         */
+        void append(const Rope &other);
+
+        /**
+         * @brief Appends a string to this rope
+         *
+         * @param other string which should be appended to this rope
+         */
+        void append(const SimpleString &other);
+
+        /*
+         * Indexed access operators
+         */
+
+        wchar_t operator[](size_t index) const noexcept(false);
+
+        /*
+         * Modification operators
+         */
+
+        Rope operator+(const Rope &other) const;
+
+        /*
+         * Comparison operators
+         */
+
+        [[nodiscard]] bool operator==(const Rope &other) const noexcept;
+
+        [[nodiscard]] bool operator!=(const Rope &other) const noexcept;
+
+        /*
+         * Non-instance operator overloads
+         */
+
+        friend std::ostream &operator<<(std::ostream &out, const Rope &rope);
+
+        friend std::wostream &operator<<(std::wostream &out, const Rope &rope);
+    };
+}
+
+#endif //SEM_2_LAB_1_ROPE_H
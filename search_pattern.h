@@ -0,0 +1,424 @@
+#ifndef SEM_2_LAB_1_SEARCH_PATTERN_H
+#define SEM_2_LAB_1_SEARCH_PATTERN_H
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+namespace lab {
+
+    class ThreadPool;
+
+    namespace search {
+
+        /**
+         * @brief Algorithm used to find a needle
+         */
+        enum class Strategy {
+            /**
+             * @brief Empty needle, it is found at the start of any haystack
+             */
+            EMPTY,
+            /**
+             * @brief Single-character needle, it is found by the vectorized character search
+             */
+            CHARACTER,
+            /**
+             * @brief Short needle, candidates are found by the vectorized first/last character filter
+             */
+            SHORT,
+            /**
+             * @brief Long needle, it is found by Boyer-Moore-Horspool algorithm
+             */
+            LONG
+        };
+
+        /**
+         * @brief Maximal length of a needle searched using {@link Strategy#SHORT} strategy
+         */
+        constexpr size_t short_needle_length = 32;
+
+        /**
+         * @brief Number of buckets in the Boyer-Moore-Horspool shift table, characters are bucketed by their low byte
+         */
+        constexpr size_t shift_table_size = 256;
+
+        /**
+         * @brief Precomputed data of a needle
+         *
+         * @note all strategies fall back to Two-Way algorithm (using the precomputed critical factorization)
+         * once they have done too much work so the search is linear in the worst case
+         */
+        struct Pattern {
+
+            /**
+             * @brief Algorithm used to find the needle
+             */
+            Strategy strategy;
+
+            /**
+             * @brief Position of the critical factorization of the needle ({@code -1} for an empty left part)
+             */
+            std::ptrdiff_t critical_position;
+
+            /**
+             * @brief Period of the needle's right part (or the shift used for non-periodic needles)
+             */
+            size_t period;
+
+            /**
+             * @brief Whether the needle's left part repeats with {@code period}, enabling the memory of Two-Way
+             */
+            bool periodic;
+
+            /**
+             * @brief Boyer-Moore-Horspool shifts by the low byte of the character, used by {@link Strategy#LONG}
+             */
+            size_t shifts[shift_table_size];
+        };
+
+        /**
+         * @brief Precomputes the data needed to find the needle
+         *
+         * @param pattern pattern to fill
+         * @param needle characters of the needle
+         * @param needle_length number of characters in the needle
+         * @note this does not allocate
+         */
+        void compile(Pattern &pattern, const wchar_t *needle, size_t needle_length) noexcept;
+
+        /**
+         * @brief Finds the first occurrence of the needle in the haystack
+         *
+         * @param pattern data precomputed for the needle
+         * @param needle characters of the needle
+         * @param needle_length number of characters in the needle
+         * @param haystack characters to search in
+         * @param length number of characters in the haystack
+         * @return index of the first occurrence or {@code length} if there is none
+         * @note the result is the same for all strategies and the worst case is linear in {@code length}
+         */
+        [[nodiscard]] size_t find(const Pattern &pattern, const wchar_t *needle, size_t needle_length,
+                                  const wchar_t *haystack, size_t length) noexcept;
+
+        /**
+         * @brief Finds the first occurrence of the needle in the haystack whose code units may be of other widths
+         *
+         * @tparam TNeedle code unit of the needle, {@code std::uint8_t}, {@code std::uint16_t} or {@code std::uint32_t}
+         * @tparam THaystack code unit of the haystack, one of the same types
+         * @param needle code units of the needle
+         * @param needle_length number of code units in the needle
+         * @param haystack code units to search in
+         * @param length number of code units in the haystack
+         * @return index of the first occurrence or {@code length} if there is none
+         * @note code units are compared by their values, the needle is found by Two-Way algorithm
+         * so the search is linear and does not allocate
+         */
+        template<typename TNeedle, typename THaystack>
+        [[nodiscard]] size_t find_code_units(const TNeedle *needle, size_t needle_length,
+                                             const THaystack *haystack, size_t length) noexcept;
+
+        /**
+         * @brief Default length of the haystacks from which they are searched in parallel
+         */
+        constexpr size_t default_parallel_threshold = size_t(1) << 22u;
+
+        /**
+         * @brief Minimal number of haystack positions checked by a single task of the parallel search
+         */
+        constexpr size_t parallel_chunk_length = size_t(1) << 18u;
+
+        /**
+         * @brief Gets the length of the haystacks from which {@code index_of} searches them in parallel
+         *
+         * @return current parallel search threshold
+         */
+        [[nodiscard]] size_t parallel_threshold() noexcept;
+
+        /**
+         * @brief Sets the length of the haystacks from which {@code index_of} searches them in parallel
+         *
+         * @param threshold new parallel search threshold, {@code SIZE_MAX} disables the parallel search
+         */
+        void set_parallel_threshold(size_t threshold) noexcept;
+
+        /**
+         * @brief Finds the first occurrence of the needle in the haystack splitting it into chunks searched in parallel
+         *
+         * @param pattern data precomputed for the needle
+         * @param needle characters of the needle
+         * @param needle_length number of characters in the needle
+         * @param haystack characters to search in
+         * @param length number of characters in the haystack
+         * @param pool pool running the searches of the chunks,
+         * if it fails to run them the whole haystack is searched by the calling thread
+         * @return index of the first occurrence or {@code length} if there is none
+         * @note chunks overlap by {@code needle_length - 1} characters and are not searched
+         * once an occurrence has been found in an earlier chunk
+         */
+        [[nodiscard]] size_t find_parallel(const Pattern &pattern, const wchar_t *needle, size_t needle_length,
+                                           const wchar_t *haystack, size_t length, ThreadPool &pool) noexcept;
+
+        /**
+         * @brief Finds the first occurrence of the character in the haystack splitting it into chunks searched in parallel
+         *
+         * @param haystack characters to search in
+         * @param length number of characters in the haystack
+         * @param character character to find
+         * @param pool pool running the searches of the chunks,
+         * if it fails to run them the whole haystack is searched by the calling thread
+         * @return index of the first occurrence or {@code length} if there is none
+         */
+        [[nodiscard]] size_t find_character_parallel(const wchar_t *haystack, size_t length, wchar_t character,
+                                                     ThreadPool &pool) noexcept;
+
+        /**
+         * @brief Finds the first occurrence of the needle in the haystack searching its chunks
+         * in parallel by {@link ThreadPool::global()}
+         *
+         * @return index of the first occurrence or {@code length} if there is none
+         */
+        [[nodiscard]] size_t find_parallel(const Pattern &pattern, const wchar_t *needle, size_t needle_length,
+                                           const wchar_t *haystack, size_t length) noexcept;
+
+        /**
+         * @brief Finds the first occurrence of the character in the haystack searching its chunks
+         * in parallel by {@link ThreadPool::global()}
+         *
+         * @return index of the first occurrence or {@code length} if there is none
+         */
+        [[nodiscard]] size_t find_character_parallel(const wchar_t *haystack, size_t length,
+                                                     wchar_t character) noexcept;
+
+        /**
+         * @brief Precomputes the data needed to find the last occurrence of the needle
+         *
+         * @param pattern pattern to fill
+         * @param needle characters of the needle
+         * @param needle_length number of characters in the needle
+         * @note this does not allocate
+         */
+        void compile_reversed(Pattern &pattern, const wchar_t *needle, size_t needle_length) noexcept;
+
+        /**
+         * @brief Finds the last occurrence of the needle in the haystack
+         *
+         * @param pattern data precomputed for the needle by {@link #compile_reversed()}
+         * @param needle characters of the needle
+         * @param needle_length number of characters in the needle
+         * @param haystack characters to search in
+         * @param length number of characters in the haystack
+         * @return index of the last occurrence or {@code length} if there is none
+         * @note the haystack is scanned backwards by Two-Way algorithm so the worst case is linear in {@code length}
+         */
+        [[nodiscard]] size_t find_last(const Pattern &pattern, const wchar_t *needle, size_t needle_length,
+                                       const wchar_t *haystack, size_t length) noexcept;
+
+        /**
+         * @brief Owned copy of a needle's characters, short needles are stored inline
+         *
+         * @note ranges keep their needles in this buffer so that a temporary needle may be passed to them
+         */
+        class NeedleBuffer {
+        protected:
+
+            /**
+             * @brief Characters of a needle of at most {@link #short_needle_length} characters
+             */
+            wchar_t inline_characters_[short_needle_length];
+
+            /**
+             * @brief Characters of a longer needle, {@code nullptr} for short ones
+             */
+            std::unique_ptr<wchar_t[]> heap_characters_;
+
+            size_t length_;
+
+        public:
+
+            /**
+             * @brief Creates a new buffer copying the characters
+             *
+             * @param characters characters of the needle
+             * @param length number of characters in the needle
+             */
+            NeedleBuffer(const wchar_t *const characters, const size_t length)
+                    : inline_characters_(), heap_characters_(length > short_needle_length
+                                                             ? std::make_unique<wchar_t[]>(length) : nullptr),
+                      length_(length) {
+                std::copy_n(characters, length, data());
+            }
+
+            NeedleBuffer(const NeedleBuffer &other) : NeedleBuffer(other.data(), other.length_) {}
+
+            NeedleBuffer &operator=(const NeedleBuffer &other) {
+                if (this != &other) {
+                    heap_characters_ = other.length_ > short_needle_length
+                                       ? std::make_unique<wchar_t[]>(other.length_) : nullptr;
+                    length_ = other.length_;
+                    std::copy_n(other.data(), length_, data());
+                }
+
+                return *this;
+            }
+
+            [[nodiscard]] const wchar_t *data() const noexcept {
+                return heap_characters_ ? heap_characters_.get() : inline_characters_;
+            }
+
+            [[nodiscard]] wchar_t *data() noexcept {
+                return heap_characters_ ? heap_characters_.get() : inline_characters_;
+            }
+
+            [[nodiscard]] size_t length() const noexcept {
+                return length_;
+            }
+        };
+
+        /**
+         * @brief Lazy range of the positions of all occurrences of a needle in a haystack, including overlapping ones
+         *
+         * @note the range refers to the characters of the haystack which should outlive it, the needle is copied
+         * @note iteration does not allocate, each step runs {@link #find()} from the position following the previous one
+         */
+        class Occurrences {
+        protected:
+
+            /**
+             * @brief Marker of the position past the last occurrence
+             */
+            static constexpr size_t no_position = SIZE_MAX;
+
+            const wchar_t *haystack_;
+
+            size_t length_;
+
+            /**
+             * @brief Copy of the needle
+             */
+            NeedleBuffer needle_;
+
+            /**
+             * @brief Data precomputed for {@code needle_}
+             */
+            Pattern pattern_;
+
+        public:
+
+            /**
+             * @brief Forward iterator over the positions
+             */
+            class Iterator {
+            protected:
+
+                /**
+                 * @brief Iterated range, {@code nullptr} for a default-constructed iterator
+                 */
+                const Occurrences *occurrences_ = nullptr;
+
+                /**
+                 * @brief Current position or {@code no_position} if the range has been exhausted
+                 */
+                size_t position_ = no_position;
+
+            public:
+
+                using iterator_concept = std::forward_iterator_tag;
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = size_t;
+                using difference_type = std::ptrdiff_t;
+
+                Iterator() noexcept = default;
+
+                /**
+                 * @brief Creates a new iterator at the given position of the range
+                 *
+                 * @param occurrences iterated range
+                 * @param position position of an occurrence or {@code no_position}
+                 */
+                Iterator(const Occurrences &occurrences, const size_t position) noexcept
+                        : occurrences_(&occurrences), position_(position) {}
+
+                [[nodiscard]] size_t operator*() const noexcept {
+                    return position_;
+                }
+
+                Iterator &operator++() noexcept {
+                    position_ = occurrences_->find_from(position_ + 1);
+                    return *this;
+                }
+
+                Iterator operator++(int) noexcept {
+                    const auto previous = *this;
+                    ++*this;
+                    return previous;
+                }
+
+                [[nodiscard]] bool operator==(const Iterator &other) const noexcept {
+                    return position_ == other.position_;
+                }
+
+                [[nodiscard]] bool operator==(std::default_sentinel_t) const noexcept {
+                    return position_ == no_position;
+                }
+            };
+
+            /**
+             * @brief Creates a new range of the occurrences of the needle in the haystack
+             *
+             * @param haystack characters to search in
+             * @param length number of characters in the haystack
+             * @param needle characters of the needle
+             * @param needle_length number of characters in the needle
+             * @note the needle is copied, it is allocated only if it is longer than {@link #short_needle_length}
+             */
+            Occurrences(const wchar_t *const haystack, const size_t length,
+                        const wchar_t *const needle, const size_t needle_length)
+                    : haystack_(haystack), length_(length), needle_(needle, needle_length), pattern_() {
+                compile(pattern_, needle_.data(), needle_length);
+            }
+
+            /**
+             * @brief Finds the first occurrence at or after the given position
+             *
+             * @param from first position to check
+             * @return position of the occurrence or {@code no_position} if there is none
+             * @note an empty needle occurs at every position up to the haystack's length inclusive
+             */
+            [[nodiscard]] size_t find_from(const size_t from) const noexcept {
+                const auto needle_length = needle_.length();
+                if (from > length_ || needle_length > length_ - from) return no_position;
+
+                const auto rest = length_ - from;
+                const auto index = find(pattern_, needle_.data(), needle_length, haystack_ + from, rest);
+                return index == rest && needle_length != 0 ? no_position : from + index;
+            }
+
+            [[nodiscard]] Iterator begin() const noexcept {
+                return Iterator(*this, find_from(0));
+            }
+
+            [[nodiscard]] std::default_sentinel_t end() const noexcept {
+                return std::default_sentinel;
+            }
+
+            /**
+             * @brief Counts the occurrences without materializing them
+             *
+             * @return number of occurrences
+             */
+            [[nodiscard]] size_t count() const noexcept {
+                size_t count = 0;
+                for (auto position = find_from(0); position != no_position; position = find_from(position + 1))
+                    ++count;
+
+                return count;
+            }
+        };
+    }
+}
+
+#endif //SEM_2_LAB_1_SEARCH_PATTERN_H
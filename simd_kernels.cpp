@@ -0,0 +1,655 @@
+#include "simd_kernels.h"
+
+#include <atomic>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LAB_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace lab::simd {
+
+    /*
+     * Scalar kernels
+     */
+
+    static size_t find_character_scalar(const wchar_t *const buffer, const size_t length,
+                                        const wchar_t character) noexcept {
+        for (size_t i = 0; i < length; ++i) if (buffer[i] == character) return i;
+        return length;
+    }
+
+    static size_t find_last_character_scalar(const wchar_t *const buffer, const size_t length,
+                                             const wchar_t character) noexcept {
+        for (auto i = length; i > 0; --i) if (buffer[i - 1] == character) return i - 1;
+        return length;
+    }
+
+    static size_t count_character_scalar(const wchar_t *const buffer, const size_t length,
+                                         const wchar_t character) noexcept {
+        size_t count = 0;
+        for (size_t i = 0; i < length; ++i) count += buffer[i] == character;
+        return count;
+    }
+
+    static size_t find_code_unit_scalar(const std::uint16_t *const buffer, const size_t length,
+                                        const std::uint16_t unit) noexcept {
+        for (size_t i = 0; i < length; ++i) if (buffer[i] == unit) return i;
+        return length;
+    }
+
+    static size_t find_pair_scalar(const wchar_t *const buffer, const size_t count,
+                                   const wchar_t first, const wchar_t last, const size_t distance) noexcept {
+        for (size_t i = 0; i < count; ++i) if (buffer[i] == first && buffer[i + distance] == last) return i;
+        return count;
+    }
+
+    static size_t mismatch_scalar(const wchar_t *const buffer, const wchar_t *const other_buffer,
+                                  const size_t length) noexcept {
+        for (size_t i = 0; i < length; ++i) if (buffer[i] != other_buffer[i]) return i;
+        return length;
+    }
+
+    static void widen_scalar(const char *const source, const size_t length, wchar_t *const destination) noexcept {
+        for (size_t i = 0; i < length; ++i) destination[i] = wchar_t(source[i]);
+    }
+
+    static size_t ascii_length_scalar(const char *const bytes, const size_t size) noexcept {
+        for (size_t i = 0; i < size; ++i) if ((unsigned char) bytes[i] >= 0x80) return i;
+        return size;
+    }
+
+    static size_t count_code_points_scalar(const char *const bytes, const size_t size) noexcept {
+        size_t count = 0;
+        for (size_t i = 0; i < size; ++i) count += ((unsigned char) bytes[i] & 0xC0u) != 0x80u;
+        return count;
+    }
+
+    static size_t narrow_ascii_scalar(const wchar_t *const source, const size_t length,
+                                      char *const destination) noexcept {
+        for (size_t i = 0; i < length; ++i) {
+            if (std::make_unsigned_t<wchar_t>(source[i]) >= 0x80) return i;
+            destination[i] = char(source[i]);
+        }
+        return length;
+    }
+
+#ifdef LAB_SIMD_X86
+    // vector kernels rely on a character being a single 32-bit lane
+    static_assert(sizeof(wchar_t) == 4 || sizeof(wchar_t) == 2);
+    static constexpr bool vectorizable = sizeof(wchar_t) == 4;
+
+    /*
+     * SSE2 kernels, 4 characters per iteration
+     */
+
+    __attribute__((target("sse2")))
+    static size_t find_character_sse2(const wchar_t *const buffer, const size_t length,
+                                      const wchar_t character) noexcept {
+        const auto pattern = _mm_set1_epi32(int(character));
+
+        size_t i = 0;
+        for (; i + 4 <= length; i += 4) {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + i));
+            const auto mask = unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, pattern))));
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+
+        return i + find_character_scalar(buffer + i, length - i, character);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t find_last_character_sse2(const wchar_t *const buffer, const size_t length,
+                                           const wchar_t character) noexcept {
+        const auto pattern = _mm_set1_epi32(int(character));
+
+        auto i = length;
+        for (; i >= 4; i -= 4) {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + i - 4));
+            const auto mask = unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, pattern))));
+            if (mask != 0) return i - 4 + (31 - __builtin_clz(mask));
+        }
+
+        const auto index = find_last_character_scalar(buffer, i, character);
+        return index == i ? length : index;
+    }
+
+    __attribute__((target("sse2")))
+    static size_t count_character_sse2(const wchar_t *const buffer, const size_t length,
+                                       const wchar_t character) noexcept {
+        const auto pattern = _mm_set1_epi32(int(character));
+
+        size_t i = 0, count = 0;
+        for (; i + 4 <= length; i += 4) {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + i));
+            count += __builtin_popcount(unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, pattern)))));
+        }
+
+        return count + count_character_scalar(buffer + i, length - i, character);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t find_code_unit_sse2(const std::uint16_t *const buffer, const size_t length,
+                                      const std::uint16_t unit) noexcept {
+        const auto pattern = _mm_set1_epi16(short(unit));
+
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + i));
+            // each matching code unit sets two bits of the mask
+            const auto mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi16(block, pattern)));
+            if (mask != 0) return i + __builtin_ctz(mask) / 2;
+        }
+
+        return i + find_code_unit_scalar(buffer + i, length - i, unit);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t find_pair_sse2(const wchar_t *const buffer, const size_t count,
+                                 const wchar_t first, const wchar_t last, const size_t distance) noexcept {
+        const auto first_pattern = _mm_set1_epi32(int(first)), last_pattern = _mm_set1_epi32(int(last));
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const auto matches = _mm_and_si128(
+                    _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + i)), first_pattern),
+                    _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + i + distance)),
+                                    last_pattern)
+            );
+            const auto mask = unsigned(_mm_movemask_ps(_mm_castsi128_ps(matches)));
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+
+        return i + find_pair_scalar(buffer + i, count - i, first, last, distance);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t mismatch_sse2(const wchar_t *const buffer, const wchar_t *const other_buffer,
+                                const size_t length) noexcept {
+        size_t i = 0;
+        for (; i + 4 <= length; i += 4) {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + i)),
+                    other_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(other_buffer + i));
+            const auto mask = unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, other_block))));
+            if (mask != 0xFu) return i + __builtin_ctz(~mask);
+        }
+
+        return i + mismatch_scalar(buffer + i, other_buffer + i, length - i);
+    }
+
+    __attribute__((target("sse2")))
+    static void widen_sse2(const char *const source, const size_t length, wchar_t *const destination) noexcept {
+        const auto zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+            // the high halves are filled with the sign bits if `char` is signed
+            const auto byte_high = std::is_signed_v<char> ? _mm_cmpgt_epi8(zero, bytes) : zero;
+            const auto low = _mm_unpacklo_epi8(bytes, byte_high), high = _mm_unpackhi_epi8(bytes, byte_high);
+            const auto low_high = std::is_signed_v<char> ? _mm_cmpgt_epi16(zero, low) : zero,
+                    high_high = std::is_signed_v<char> ? _mm_cmpgt_epi16(zero, high) : zero;
+
+            const auto output = reinterpret_cast<__m128i *>(destination + i);
+            _mm_storeu_si128(output, _mm_unpacklo_epi16(low, low_high));
+            _mm_storeu_si128(output + 1, _mm_unpackhi_epi16(low, low_high));
+            _mm_storeu_si128(output + 2, _mm_unpacklo_epi16(high, high_high));
+            _mm_storeu_si128(output + 3, _mm_unpackhi_epi16(high, high_high));
+        }
+
+        widen_scalar(source + i, length - i, destination + i);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t ascii_length_sse2(const char *const bytes, const size_t size) noexcept {
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16) {
+            const auto mask = unsigned(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i))));
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+
+        return i + ascii_length_scalar(bytes + i, size - i);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t count_code_points_sse2(const char *const bytes, const size_t size) noexcept {
+        // continuation bytes are 0x80-0xBF, i.e. -128..-65 when compared as signed bytes
+        const auto threshold = _mm_set1_epi8(-65);
+
+        size_t i = 0, count = 0;
+        for (; i + 16 <= size; i += 16) {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+            count += __builtin_popcount(unsigned(_mm_movemask_epi8(_mm_cmpgt_epi8(block, threshold))));
+        }
+
+        return count + count_code_points_scalar(bytes + i, size - i);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t narrow_ascii_sse2(const wchar_t *const source, const size_t length,
+                                    char *const destination) noexcept {
+        const auto non_ascii = _mm_set1_epi32(~0x7F);
+
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const auto input = reinterpret_cast<const __m128i *>(source + i);
+            const auto first = _mm_loadu_si128(input), second = _mm_loadu_si128(input + 1),
+                    third = _mm_loadu_si128(input + 2), fourth = _mm_loadu_si128(input + 3);
+            const auto any = _mm_and_si128(_mm_or_si128(_mm_or_si128(first, second), _mm_or_si128(third, fourth)),
+                                           non_ascii);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(any, _mm_setzero_si128())) != 0xFFFF) break;
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm_packus_epi16(
+                    _mm_packs_epi32(first, second), _mm_packs_epi32(third, fourth)
+            ));
+        }
+
+        return i + narrow_ascii_scalar(source + i, length - i, destination + i);
+    }
+
+    /*
+     * AVX2 kernels, 16 characters per iteration (two vectors to hide the latency of the comparison)
+     */
+
+    __attribute__((target("avx2")))
+    static size_t find_character_avx2(const wchar_t *const buffer, const size_t length,
+                                      const wchar_t character) noexcept {
+        const auto pattern = _mm256_set1_epi32(int(character));
+
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const auto low = _mm256_cmpeq_epi32(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buffer + i)), pattern
+            ), high = _mm256_cmpeq_epi32(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buffer + i + 8)), pattern
+            );
+            if (!_mm256_testz_si256(_mm256_or_si256(low, high), _mm256_or_si256(low, high))) {
+                const auto mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(low)))
+                                  | unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(high))) << 8u;
+                return i + __builtin_ctz(mask);
+            }
+        }
+        for (; i + 8 <= length; i += 8) {
+            const auto mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buffer + i)), pattern
+            ))));
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+
+        return i + find_character_scalar(buffer + i, length - i, character);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t find_last_character_avx2(const wchar_t *const buffer, const size_t length,
+                                           const wchar_t character) noexcept {
+        const auto pattern = _mm256_set1_epi32(int(character));
+
+        auto i = length;
+        for (; i >= 8; i -= 8) {
+            const auto mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buffer + i - 8)), pattern
+            ))));
+            if (mask != 0) return i - 8 + (31 - __builtin_clz(mask));
+        }
+
+        const auto index = find_last_character_scalar(buffer, i, character);
+        return index == i ? length : index;
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    static size_t count_character_avx2(const wchar_t *const buffer, const size_t length,
+                                       const wchar_t character) noexcept {
+        const auto pattern = _mm256_set1_epi32(int(character));
+
+        size_t i = 0, count = 0;
+        for (; i + 8 <= length; i += 8) {
+            count += __builtin_popcount(unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buffer + i)), pattern
+            )))));
+        }
+
+        return count + count_character_scalar(buffer + i, length - i, character);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t find_code_unit_avx2(const std::uint16_t *const buffer, const size_t length,
+                                      const std::uint16_t unit) noexcept {
+        const auto pattern = _mm256_set1_epi16(short(unit));
+
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const auto mask = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi16(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buffer + i)), pattern
+            )));
+            if (mask != 0) return i + __builtin_ctz(mask) / 2;
+        }
+
+        return i + find_code_unit_sse2(buffer + i, length - i, unit);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t find_pair_avx2(const wchar_t *const buffer, const size_t count,
+                                 const wchar_t first, const wchar_t last, const size_t distance) noexcept {
+        const auto first_pattern = _mm256_set1_epi32(int(first)), last_pattern = _mm256_set1_epi32(int(last));
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const auto matches = _mm256_and_si256(
+                    _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(buffer + i)),
+                                       first_pattern),
+                    _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(buffer + i + distance)),
+                                       last_pattern)
+            );
+            const auto mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(matches)));
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+
+        return i + find_pair_scalar(buffer + i, count - i, first, last, distance);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t mismatch_avx2(const wchar_t *const buffer, const wchar_t *const other_buffer,
+                                const size_t length) noexcept {
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buffer + i)),
+                    other_block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(other_buffer + i));
+            const auto mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(
+                    _mm256_cmpeq_epi32(block, other_block)
+            )));
+            if (mask != 0xFFu) return i + __builtin_ctz(~mask);
+        }
+
+        return i + mismatch_scalar(buffer + i, other_buffer + i, length - i);
+    }
+
+    __attribute__((target("avx2")))
+    static void widen_avx2(const char *const source, const size_t length, wchar_t *const destination) noexcept {
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+            const auto output = reinterpret_cast<__m256i *>(destination + i);
+            if constexpr (std::is_signed_v<char>) {
+                _mm256_storeu_si256(output, _mm256_cvtepi8_epi32(bytes));
+                _mm256_storeu_si256(output + 1, _mm256_cvtepi8_epi32(_mm_srli_si128(bytes, 8)));
+            } else {
+                _mm256_storeu_si256(output, _mm256_cvtepu8_epi32(bytes));
+                _mm256_storeu_si256(output + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+            }
+        }
+
+        widen_scalar(source + i, length - i, destination + i);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t ascii_length_avx2(const char *const bytes, const size_t size) noexcept {
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            const auto mask = unsigned(_mm256_movemask_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i))
+            ));
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+
+        return i + ascii_length_sse2(bytes + i, size - i);
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    static size_t count_code_points_avx2(const char *const bytes, const size_t size) noexcept {
+        const auto threshold = _mm256_set1_epi8(-65);
+
+        size_t i = 0, count = 0;
+        for (; i + 32 <= size; i += 32) {
+            const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i));
+            count += __builtin_popcount(unsigned(_mm256_movemask_epi8(_mm256_cmpgt_epi8(block, threshold))));
+        }
+
+        return count + count_code_points_sse2(bytes + i, size - i);
+    }
+
+    /*
+     * AVX-512 kernels, 16 characters per iteration with a masked tail
+     */
+
+    __attribute__((target("avx512f")))
+    static size_t find_character_avx512(const wchar_t *const buffer, const size_t length,
+                                        const wchar_t character) noexcept {
+        const auto pattern = _mm512_set1_epi32(int(character));
+
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const auto mask = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(buffer + i), pattern);
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+        if (i < length) {
+            const auto tail = __mmask16((1u << (length - i)) - 1u);
+            const auto mask = _mm512_mask_cmpeq_epi32_mask(tail, _mm512_maskz_loadu_epi32(tail, buffer + i), pattern);
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+
+        return length;
+    }
+
+    __attribute__((target("avx512f")))
+    static size_t find_pair_avx512(const wchar_t *const buffer, const size_t count,
+                                   const wchar_t first, const wchar_t last, const size_t distance) noexcept {
+        const auto first_pattern = _mm512_set1_epi32(int(first)), last_pattern = _mm512_set1_epi32(int(last));
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const auto mask = _mm512_mask_cmpeq_epi32_mask(
+                    _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(buffer + i), first_pattern),
+                    _mm512_loadu_si512(buffer + i + distance), last_pattern
+            );
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+        if (i < count) {
+            const auto tail = __mmask16((1u << (count - i)) - 1u);
+            const auto mask = _mm512_mask_cmpeq_epi32_mask(
+                    _mm512_mask_cmpeq_epi32_mask(tail, _mm512_maskz_loadu_epi32(tail, buffer + i), first_pattern),
+                    _mm512_maskz_loadu_epi32(tail, buffer + i + distance), last_pattern
+            );
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+
+        return count;
+    }
+
+    __attribute__((target("avx512f")))
+    static size_t mismatch_avx512(const wchar_t *const buffer, const wchar_t *const other_buffer,
+                                  const size_t length) noexcept {
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const auto mask = _mm512_cmpneq_epi32_mask(
+                    _mm512_loadu_si512(buffer + i), _mm512_loadu_si512(other_buffer + i)
+            );
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+        if (i < length) {
+            const auto tail = __mmask16((1u << (length - i)) - 1u);
+            const auto mask = _mm512_mask_cmpneq_epi32_mask(
+                    tail, _mm512_maskz_loadu_epi32(tail, buffer + i), _mm512_maskz_loadu_epi32(tail, other_buffer + i)
+            );
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+
+        return length;
+    }
+    __attribute__((target("avx512f")))
+    static void widen_avx512(const char *const source, const size_t length, wchar_t *const destination) noexcept {
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+            // the zero-masked forms do not pass an undefined source which GCC reports as uninitialized
+            if constexpr (std::is_signed_v<char>)
+                _mm512_storeu_si512(destination + i, _mm512_maskz_cvtepi8_epi32(__mmask16(-1), bytes));
+            else _mm512_storeu_si512(destination + i, _mm512_maskz_cvtepu8_epi32(__mmask16(-1), bytes));
+        }
+
+        widen_scalar(source + i, length - i, destination + i);
+    }
+#else
+    static constexpr bool vectorizable = false;
+#endif
+
+    /*
+     * Runtime dispatch
+     */
+
+    /**
+     * @brief Set of kernels implemented using the same instruction set
+     */
+    struct Kernels {
+        InstructionSet instruction_set;
+
+        size_t (*find_character)(const wchar_t *, size_t, wchar_t) noexcept;
+
+        size_t (*find_last_character)(const wchar_t *, size_t, wchar_t) noexcept;
+
+        size_t (*count_character)(const wchar_t *, size_t, wchar_t) noexcept;
+
+        size_t (*find_code_unit)(const std::uint16_t *, size_t, std::uint16_t) noexcept;
+
+        size_t (*find_pair)(const wchar_t *, size_t, wchar_t, wchar_t, size_t) noexcept;
+
+        size_t (*mismatch)(const wchar_t *, const wchar_t *, size_t) noexcept;
+
+        void (*widen)(const char *, size_t, wchar_t *) noexcept;
+
+        size_t (*ascii_length)(const char *, size_t) noexcept;
+
+        size_t (*count_code_points)(const char *, size_t) noexcept;
+
+        size_t (*narrow_ascii)(const wchar_t *, size_t, char *) noexcept;
+    };
+
+    static constexpr Kernels SCALAR_KERNELS{
+            InstructionSet::SCALAR, find_character_scalar, find_last_character_scalar, count_character_scalar,
+            find_code_unit_scalar, find_pair_scalar, mismatch_scalar, widen_scalar,
+            ascii_length_scalar, count_code_points_scalar, narrow_ascii_scalar
+    };
+#ifdef LAB_SIMD_X86
+    static constexpr Kernels SSE2_KERNELS{
+            InstructionSet::SSE2, find_character_sse2, find_last_character_sse2, count_character_sse2,
+            find_code_unit_sse2, find_pair_sse2, mismatch_sse2, widen_sse2,
+            ascii_length_sse2, count_code_points_sse2, narrow_ascii_sse2
+    };
+    static constexpr Kernels AVX2_KERNELS{
+            InstructionSet::AVX2, find_character_avx2, find_last_character_avx2, count_character_avx2,
+            find_code_unit_avx2, find_pair_avx2, mismatch_avx2, widen_avx2,
+            ascii_length_avx2, count_code_points_avx2, narrow_ascii_sse2
+    };
+    static constexpr Kernels AVX512_KERNELS{
+            // the backward search and counting are bound by the loads so they use the AVX2 kernels
+            InstructionSet::AVX512, find_character_avx512, find_last_character_avx2, count_character_avx2,
+            // 16-bit comparisons need AVX512BW so the AVX2 kernel is used for them
+            find_code_unit_avx2, find_pair_avx512, mismatch_avx512, widen_avx512,
+            // byte-wise AVX-512 operations need AVX512BW so the AVX2 kernels are used for bytes
+            ascii_length_avx2, count_code_points_avx2, narrow_ascii_sse2
+    };
+#endif
+
+    static const Kernels *kernels_of(const InstructionSet instruction_set) noexcept {
+        switch (instruction_set) {
+#ifdef LAB_SIMD_X86
+            case InstructionSet::AVX512: return &AVX512_KERNELS;
+            case InstructionSet::AVX2: return &AVX2_KERNELS;
+            case InstructionSet::SSE2: return &SSE2_KERNELS;
+#endif
+            default: return &SCALAR_KERNELS;
+        }
+    }
+
+    InstructionSet detected_instruction_set() noexcept {
+        static const auto detected = []() noexcept {
+            if constexpr (!vectorizable) return InstructionSet::SCALAR;
+#ifdef LAB_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return InstructionSet::AVX512;
+            if (__builtin_cpu_supports("avx2")) return InstructionSet::AVX2;
+            if (__builtin_cpu_supports("sse2")) return InstructionSet::SSE2;
+#endif
+            return InstructionSet::SCALAR;
+        }();
+
+        return detected;
+    }
+
+    /**
+     * @brief Gets the storage of the active kernels initializing it with the detected ones
+     *
+     * @return reference to the pointer to the active kernels
+     */
+    static std::atomic<const Kernels *> &active_kernels() noexcept {
+        static std::atomic<const Kernels *> kernels{kernels_of(detected_instruction_set())};
+        return kernels;
+    }
+
+    InstructionSet instruction_set() noexcept {
+        return active_kernels().load(std::memory_order_relaxed)->instruction_set;
+    }
+
+    InstructionSet use_instruction_set(const InstructionSet instruction_set) noexcept {
+        const auto detected = detected_instruction_set();
+        const auto used = instruction_set < detected ? instruction_set : detected;
+        active_kernels().store(kernels_of(used), std::memory_order_relaxed);
+
+        return used;
+    }
+
+    const char *name_of(const InstructionSet instruction_set) noexcept {
+        switch (instruction_set) {
+            case InstructionSet::SSE2: return "sse2";
+            case InstructionSet::AVX2: return "avx2";
+            case InstructionSet::AVX512: return "avx512";
+            default: return "scalar";
+        }
+    }
+
+    size_t find_character(const wchar_t *const buffer, const size_t length, const wchar_t character) noexcept {
+        return active_kernels().load(std::memory_order_relaxed)->find_character(buffer, length, character);
+    }
+
+    size_t find_last_character(const wchar_t *const buffer, const size_t length, const wchar_t character) noexcept {
+        return active_kernels().load(std::memory_order_relaxed)->find_last_character(buffer, length, character);
+    }
+
+    size_t count_character(const wchar_t *const buffer, const size_t length, const wchar_t character) noexcept {
+        return active_kernels().load(std::memory_order_relaxed)->count_character(buffer, length, character);
+    }
+
+    size_t find_code_unit(const std::uint16_t *const buffer, const size_t length, const std::uint16_t unit) noexcept {
+        return active_kernels().load(std::memory_order_relaxed)->find_code_unit(buffer, length, unit);
+    }
+
+    size_t find_pair(const wchar_t *const buffer, const size_t count,
+                     const wchar_t first, const wchar_t last, const size_t distance) noexcept {
+        return active_kernels().load(std::memory_order_relaxed)->find_pair(buffer, count, first, last, distance);
+    }
+
+    size_t mismatch(const wchar_t *const buffer, const wchar_t *const other_buffer, const size_t length) noexcept {
+        return active_kernels().load(std::memory_order_relaxed)->mismatch(buffer, other_buffer, length);
+    }
+
+    void widen(const char *const source, const size_t length, wchar_t *const destination) noexcept {
+        active_kernels().load(std::memory_order_relaxed)->widen(source, length, destination);
+    }
+
+    size_t ascii_length(const char *const bytes, const size_t size) noexcept {
+        return active_kernels().load(std::memory_order_relaxed)->ascii_length(bytes, size);
+    }
+
+    size_t count_code_points(const char *const bytes, const size_t size) noexcept {
+        return active_kernels().load(std::memory_order_relaxed)->count_code_points(bytes, size);
+    }
+
+    size_t narrow_ascii(const wchar_t *const source, const size_t length, char *const destination) noexcept {
+        return active_kernels().load(std::memory_order_relaxed)->narrow_ascii(source, length, destination);
+    }
+
+    AsciiKernels ascii_kernels() noexcept {
+        const auto kernels = active_kernels().load(std::memory_order_relaxed);
+        return AsciiKernels{kernels->ascii_length, kernels->widen, kernels->narrow_ascii};
+    }
+}
@@ -0,0 +1,169 @@
+#ifndef SEM_2_LAB_1_SIMD_KERNELS_H
+#define SEM_2_LAB_1_SIMD_KERNELS_H
+
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lab::simd {
+
+    /**
+     * @brief Instruction set used by the kernels, ordered from the least to the most capable
+     */
+    enum class InstructionSet {
+        SCALAR, SSE2, AVX2, AVX512
+    };
+
+    /**
+     * @brief Gets the most capable instruction set supported by the current CPU
+     *
+     * @return detected instruction set
+     */
+    [[nodiscard]] InstructionSet detected_instruction_set() noexcept;
+
+    /**
+     * @brief Gets the instruction set currently used by the kernels
+     *
+     * @return active instruction set
+     */
+    [[nodiscard]] InstructionSet instruction_set() noexcept;
+
+    /**
+     * @brief Makes the kernels use the given instruction set
+     *
+     * @param instruction_set instruction set to use
+     * @return instruction set which is actually used, this is the given one limited by the detected one
+     */
+    InstructionSet use_instruction_set(InstructionSet instruction_set) noexcept;
+
+    /**
+     * @brief Gets the name of the given instruction set
+     *
+     * @param instruction_set instruction set
+     * @return human-readable name of the instruction set
+     */
+    [[nodiscard]] const char *name_of(InstructionSet instruction_set) noexcept;
+
+    /**
+     * @brief Finds the first occurrence of the character in the buffer
+     *
+     * @param buffer characters to search in
+     * @param length number of characters in the buffer
+     * @param character character to find
+     * @return index of the first occurrence or {@code length} if there is none
+     */
+    [[nodiscard]] size_t find_character(const wchar_t *buffer, size_t length, wchar_t character) noexcept;
+
+    /**
+     * @brief Finds the last occurrence of the character in the buffer
+     *
+     * @param buffer characters to search in
+     * @param length number of characters in the buffer
+     * @param character character to find
+     * @return index of the last occurrence or {@code length} if there is none
+     */
+    [[nodiscard]] size_t find_last_character(const wchar_t *buffer, size_t length, wchar_t character) noexcept;
+
+    /**
+     * @brief Counts the occurrences of the character in the buffer
+     *
+     * @param buffer characters to count in
+     * @param length number of characters in the buffer
+     * @param character character to count
+     * @return number of occurrences
+     */
+    [[nodiscard]] size_t count_character(const wchar_t *buffer, size_t length, wchar_t character) noexcept;
+
+    /**
+     * @brief Finds the first occurrence of the 16-bit code unit in the buffer
+     *
+     * @param buffer code units to search in
+     * @param length number of code units in the buffer
+     * @param unit code unit to find
+     * @return index of the first occurrence or {@code length} if there is none
+     */
+    [[nodiscard]] size_t find_code_unit(const std::uint16_t *buffer, size_t length, std::uint16_t unit) noexcept;
+
+    /**
+     * @brief Finds the first position at which the buffer has the given characters at the given distance
+     *
+     * @param buffer characters to search in, at least {@code count + distance} of them should be readable
+     * @param count number of positions to check
+     * @param first character expected at the position
+     * @param last character expected at the position increased by {@code distance}
+     * @param distance distance between the characters
+     * @return the first position {@code i} such that {@code buffer[i] == first && buffer[i + distance] == last}
+     * or {@code count} if there is none
+     */
+    [[nodiscard]] size_t find_pair(const wchar_t *buffer, size_t count,
+                                   wchar_t first, wchar_t last, size_t distance) noexcept;
+
+    /**
+     * @brief Finds the first index at which the buffers differ
+     *
+     * @param buffer first buffer
+     * @param other_buffer second buffer
+     * @param length number of characters to compare
+     * @return index of the first mismatching character or {@code length} if the buffers are equal
+     */
+    [[nodiscard]] size_t mismatch(const wchar_t *buffer, const wchar_t *other_buffer, size_t length) noexcept;
+
+    /**
+     * @brief Converts the narrow characters to wide ones as {@code wchar_t(character)} does
+     *
+     * @param source narrow characters
+     * @param length number of characters to convert
+     * @param destination buffer of at least {@code length} wide characters
+     */
+    void widen(const char *source, size_t length, wchar_t *destination) noexcept;
+
+    /**
+     * @brief Finds the first byte which is not an ASCII character
+     *
+     * @param bytes bytes to check
+     * @param size number of bytes
+     * @return index of the first byte not less than {@code 0x80} or {@code size} if all bytes are ASCII
+     */
+    [[nodiscard]] size_t ascii_length(const char *bytes, size_t size) noexcept;
+
+    /**
+     * @brief Counts the UTF-8 code points assuming that the bytes are valid UTF-8
+     *
+     * @param bytes bytes to count in
+     * @param size number of bytes
+     * @return number of bytes which are not continuation bytes
+     */
+    [[nodiscard]] size_t count_code_points(const char *bytes, size_t size) noexcept;
+
+    /**
+     * @brief Converts the leading ASCII characters to narrow ones
+     *
+     * @param source wide characters
+     * @param length number of wide characters
+     * @param destination buffer of at least {@code length} narrow characters
+     * @return index of the first character which is not ASCII or {@code length} if all characters are converted
+     */
+    [[nodiscard]] size_t narrow_ascii(const wchar_t *source, size_t length, char *destination) noexcept;
+
+    /**
+     * @brief Active kernels converting ASCII runs
+     *
+     * @note loops converting many runs fetch them once rather than dispatching on each call
+     */
+    struct AsciiKernels {
+        size_t (*ascii_length)(const char *bytes, size_t size) noexcept;
+
+        void (*widen)(const char *source, size_t length, wchar_t *destination) noexcept;
+
+        size_t (*narrow_ascii)(const wchar_t *source, size_t length, char *destination) noexcept;
+    };
+
+    /**
+     * @brief Gets the active kernels converting ASCII runs
+     *
+     * @return kernels of the active instruction set, they stay valid if it is changed
+     */
+    [[nodiscard]] AsciiKernels ascii_kernels() noexcept;
+}
+
+#endif //SEM_2_LAB_1_SIMD_KERNELS_H
@@ -1,9 +1,21 @@
 #include "simple_string.h"
+#include "simd_kernels.h"
+#include "string_search.h"
+#include "string_hash.h"
+#include "instrumentation.h"
+#include "thread_pool.h"
 
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
+#include <stdexcept>
+#include <string>
+#include <atomic>
+#include <new>
 #include <utility>
+#include <climits>
+#include <istream>
+#include <streambuf>
 #include <algorithm>
 
 namespace lab {
@@ -13,32 +25,97 @@ namespace lab {
      */
 
     /**
-     * @brief Calculates the new capacity of the string's buffer based on the current one and the minimal required
+     * @brief Header preceding the characters of a heap buffer when copy-on-write is enabled
+     */
+    struct SharedHeader {
+
+        /**
+         * @brief Number of strings sharing the buffer or {@code 0} if the buffer is owned by a single string
+         * which has given out a mutable reference to its character and thus cannot share it
+         */
+        std::atomic<size_t> references;
+    };
+
+    /**
+     * @brief Size of the header preceding the characters of a heap buffer
+     */
+    static constexpr size_t header_size = SimpleString::copy_on_write ? sizeof(SharedHeader) : 0;
+
+    static_assert(header_size % alignof(wchar_t) == 0);
+
+    /**
+     * @brief Size of a memory page to which big buffers are rounded by {@code GrowthPolicy::PAGE_ROUNDED}
+     */
+    static constexpr size_t page_size = 4096;
+
+    /**
+     * @brief Alignment of a heap buffer
+     */
+    static constexpr size_t buffer_alignment = SimpleString::copy_on_write ? alignof(SharedHeader) : alignof(wchar_t);
+
+    /**
+     * @brief Gets the header of the heap buffer
      *
-     * @param current_capacity current capacity of the string's buffer
-     * @param required_capacity minimal required capacity of the string's buffer
-     * @return new capacity of the string's buffer
+     * @param buffer characters of the heap buffer
+     * @return header of the buffer
      */
-    static inline size_t calculate_new_capacity(size_t current_capacity, size_t required_capacity) {
-        if (current_capacity == SIZE_MAX) throw std::overflow_error("No more space available in this string");
+    static inline SharedHeader *header_of(wchar_t *const buffer) noexcept {
+        return std::launder(reinterpret_cast<SharedHeader *>(reinterpret_cast<char *>(buffer) - header_size));
+    }
 
-        // multiply the current size by averagely 1.5
-        const auto new_capacity = current_capacity + (current_capacity >> 1u);
+    /**
+     * @brief Allocates a new heap buffer owned by a single string
+     *
+     * @param resource memory resource to allocate the buffer from
+     * @param capacity number of characters in the buffer
+     * @return characters of the allocated buffer
+     */
+    static wchar_t *allocate_heap_buffer(std::pmr::memory_resource *const resource, const size_t capacity) {
+        if (capacity > (SIZE_MAX - header_size) / sizeof(wchar_t)) throw std::bad_array_new_length();
+
+        const auto size = header_size + capacity * sizeof(wchar_t);
+        const auto memory = static_cast<char *>(resource->allocate(size, buffer_alignment));
+        instrumentation::record(instrumentation::Event::ALLOCATION, size);
+        if constexpr (SimpleString::copy_on_write) new(memory) SharedHeader{1};
+
+        return reinterpret_cast<wchar_t *>(memory + header_size);
+    }
+
+    /**
+     * @brief Releases the heap buffer freeing it if no other string shares it
+     *
+     * @param resource memory resource which has allocated the buffer
+     * @param buffer characters of the heap buffer
+     * @param capacity number of characters in the buffer
+     */
+    static void release_heap_buffer(std::pmr::memory_resource *const resource, wchar_t *const buffer,
+                                    const size_t capacity) noexcept {
+        if constexpr (SimpleString::copy_on_write) {
+            const auto header = header_of(buffer);
+            // unshareable buffer (with 0 references) has the only owner as well as the one with 1 reference
+            if (header->references.load(std::memory_order_acquire) > 1
+                && header->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+            header->~SharedHeader();
+        }
 
-        return new_capacity >= required_capacity ? new_capacity : required_capacity;
+        const auto size = header_size + capacity * sizeof(wchar_t);
+        resource->deallocate(reinterpret_cast<char *>(buffer) - header_size, size, buffer_alignment);
+        instrumentation::record(instrumentation::Event::DEALLOCATION, size);
     }
 
     /*
      * Protected constructors
      */
 
-    SimpleString::SimpleString(const size_t length)
-            : buffer_(new wchar_t[length]), capacity_(length), length_(length) {}
+    SimpleString::SimpleString(const size_t length, std::pmr::memory_resource *const resource)
+            : SimpleString(length, length, resource) {}
 
-    SimpleString::SimpleString(const size_t length, const size_t capacity) {
+    SimpleString::SimpleString(const size_t length, const size_t capacity, std::pmr::memory_resource *const resource)
+            : resource_(resource) {
         assert((length <= capacity));
 
-        buffer_ = new wchar_t[capacity_ = capacity];
+        allocate(capacity);
         length_ = length;
     }
 
@@ -50,56 +127,238 @@ namespace lab {
         if (index >= length_) throw std::out_of_range("Index " + std::to_string(index) + " exceeds string length");
     }
 
+    bool SimpleString::is_inline() const noexcept {
+        return buffer_ == inline_buffer_;
+    }
+
+    void SimpleString::allocate(const size_t capacity) {
+        if (capacity <= inline_capacity) {
+            buffer_ = inline_buffer_;
+            capacity_ = inline_capacity;
+        } else {
+            buffer_ = allocate_heap_buffer(resource_, capacity);
+            capacity_ = capacity;
+        }
+    }
+
+    void SimpleString::deallocate() noexcept {
+        if (!is_inline()) release_heap_buffer(resource_, buffer_, capacity_);
+    }
+
+    bool SimpleString::share(const SimpleString &original) noexcept {
+        if constexpr (copy_on_write) {
+            if (original.is_inline() || *resource_ != *original.resource_) return false;
+
+            auto &references = header_of(original.buffer_)->references;
+            if (references.load(std::memory_order_relaxed) == 0) return false;
+
+            references.fetch_add(1, std::memory_order_relaxed);
+            buffer_ = original.buffer_;
+            capacity_ = original.capacity_;
+            length_ = original.length_;
+
+            return true;
+        } else return false;
+    }
+
+    void SimpleString::detach() {
+        if constexpr (copy_on_write) {
+            if (is_inline() || header_of(buffer_)->references.load(std::memory_order_acquire) <= 1) return;
+
+            const auto shared_buffer = buffer_;
+            buffer_ = allocate_heap_buffer(resource_, capacity_);
+            std::copy(shared_buffer, shared_buffer + length_, buffer_);
+            release_heap_buffer(resource_, shared_buffer, capacity_);
+            instrumentation::record(instrumentation::Event::COPY, length_ * sizeof(wchar_t));
+        }
+    }
+
+    void SimpleString::make_unshareable() {
+        if constexpr (copy_on_write) {
+            detach();
+            if (!is_inline()) header_of(buffer_)->references.store(0, std::memory_order_relaxed);
+        }
+    }
+
     inline void SimpleString::ensure_capacity(size_t required_capacity) {
         const auto capacity = capacity_;
-        if (capacity < required_capacity) resize_to(calculate_new_capacity(capacity, required_capacity));
+        // resizing creates a new buffer so it does not have to be detached
+        if (capacity < required_capacity) {
+            const auto new_capacity = calculate_new_capacity(growth_policy_, capacity, required_capacity,
+                                                             sizeof(wchar_t), header_size);
+            instrumentation::record(instrumentation::Event::GROWTH, new_capacity * sizeof(wchar_t));
+            resize_to(new_capacity);
+        }
+        else detach();
     }
 
     void SimpleString::resize_to(const size_t new_capacity) {
-        if (capacity_ != new_capacity) {
-            const auto new_buffer = new wchar_t[new_capacity];
-            const auto new_length = std::min(length_, new_capacity);
+        // inline buffer cannot be resized so any capacity fitting into it means staying (or becoming) inline
+        if (new_capacity <= inline_capacity ? is_inline() : capacity_ == new_capacity) return;
+
+        const auto old_buffer = buffer_;
+        const auto old_capacity = capacity_;
+        const auto was_inline = is_inline();
+        const auto new_length = std::min(length_, new_capacity);
+
+        if (new_capacity <= inline_capacity) {
+            buffer_ = inline_buffer_;
+            capacity_ = inline_capacity;
+        } else {
+            // the old buffer stays valid (even if it is the inline one) until the characters are copied
+            buffer_ = allocate_heap_buffer(resource_, new_capacity);
+            capacity_ = new_capacity;
+        }
 
-            std::copy(buffer_, buffer_ + new_length, new_buffer);
-            delete[] buffer_;
-            buffer_ = new_buffer;
+        std::copy(old_buffer, old_buffer + new_length, buffer_);
+        if (!was_inline) release_heap_buffer(resource_, old_buffer, old_capacity);
+        instrumentation::record(instrumentation::Event::REALLOCATION, new_length * sizeof(wchar_t));
 
-            capacity_ = new_capacity;
-            length_ = new_length;
+        length_ = new_length;
+    }
+
+    void SimpleString::discard_shared_buffer() noexcept {
+        if constexpr (copy_on_write) {
+            if (is_inline() || header_of(buffer_)->references.load(std::memory_order_acquire) <= 1) return;
+
+            deallocate();
+            buffer_ = inline_buffer_;
+            capacity_ = inline_capacity;
+            length_ = 0;
         }
     }
 
+    inline void SimpleString::invalidate_hash() noexcept {
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+        hash_.store(0, std::memory_order_relaxed);
+        // the modification invalidates the references given out before as it does for std::basic_string
+        hash_uncacheable_ = false;
+#endif
+    }
+
+    inline void SimpleString::make_hash_uncacheable() noexcept {
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+        hash_.store(0, std::memory_order_relaxed);
+        hash_uncacheable_ = true;
+#endif
+    }
+
+    wchar_t *SimpleString::extend(const size_t count) {
+        const auto length = length_;
+        if (count > SIZE_MAX - length) throw std::overflow_error("No more space available in this string");
+
+        ensure_capacity(length + count);
+        invalidate_hash();
+        length_ = length + count;
+
+        return buffer_ + length;
+    }
+
+    void SimpleString::truncate(const size_t length) noexcept {
+        assert(length <= length_);
+
+        invalidate_hash();
+        length_ = length;
+    }
+
+    size_t SimpleString::calculate_new_capacity(const GrowthPolicy growth_policy, const size_t current_capacity,
+                                                const size_t required_capacity, const size_t character_size,
+                                                const size_t header) {
+        if (current_capacity == SIZE_MAX) throw std::overflow_error("No more space available in this string");
+
+        size_t new_capacity;
+        if (growth_policy == GrowthPolicy::DOUBLE) {
+            new_capacity = current_capacity > SIZE_MAX / 2 ? SIZE_MAX : current_capacity * 2;
+        } else {
+            // multiply the current size by averagely 1.5
+            const auto increment = current_capacity >> 1u;
+            new_capacity = current_capacity > SIZE_MAX - increment ? SIZE_MAX : current_capacity + increment;
+        }
+        if (new_capacity < required_capacity) new_capacity = required_capacity;
+
+        if (growth_policy == GrowthPolicy::PAGE_ROUNDED
+            && new_capacity >= page_size / character_size
+            && new_capacity <= (SIZE_MAX - header - page_size) / character_size) {
+            // the whole allocation (including the header) fills its last page
+            const auto size = (header + new_capacity * character_size + page_size - 1) / page_size * page_size;
+            new_capacity = (size - header) / character_size;
+        }
+
+        return new_capacity;
+    }
+
     /*
      * Public constructors
      */
 
     SimpleString::SimpleString() : SimpleString((size_t) 0) {}
 
-    SimpleString::SimpleString(const size_t length, const wchar_t symbol) : SimpleString(length) {
+    SimpleString::SimpleString(std::pmr::memory_resource *const resource) : SimpleString((size_t) 0, resource) {}
+
+    SimpleString::SimpleString(const size_t length, const wchar_t symbol, std::pmr::memory_resource *const resource)
+            : SimpleString(length, resource) {
         for (size_t i = 0; i < length; ++i) buffer_[i] = symbol;
     }
 
-    SimpleString::SimpleString(char const *wide_c_string) : SimpleString(strlen(wide_c_string)) {
-        // note: trailing '\0' is not copied
-        mbstowcs(buffer_, wide_c_string, length_);
-    }
+    SimpleString::SimpleString(char const *c_string, std::pmr::memory_resource *const resource)
+            : SimpleString(from_utf8(c_string, strlen(c_string), resource)) {}
 
-    SimpleString::SimpleString(wchar_t const *wide_c_string) : SimpleString(wcslen(wide_c_string)) {
+    SimpleString::SimpleString(wchar_t const *wide_c_string, std::pmr::memory_resource *const resource)
+            : SimpleString(wcslen(wide_c_string), resource) {
         // note: trailing '\0' is not copied
         std::copy(wide_c_string, wide_c_string + length_, buffer_);
     }
 
+    SimpleString::SimpleString(const SimpleStringView view, std::pmr::memory_resource *const resource)
+            : SimpleString(view.length(), resource) {
+        const auto data = view.data();
+        std::copy(data, data + length_, buffer_);
+    }
+
+    SimpleString SimpleString::from_utf8(const char *const bytes, const size_t size,
+                                         std::pmr::memory_resource *const resource) {
+        SimpleString string(utf8::decoded_length(bytes, size), resource);
+        utf8::decode(bytes, size, string.buffer_);
+
+        return string;
+    }
+
     /*
      * Special constructors
      */
 
-    SimpleString::SimpleString(const SimpleString &original) : SimpleString(original.length_) {
+    SimpleString::SimpleString(const SimpleString &original)
+            : SimpleString(original, std::pmr::get_default_resource()) {}
+
+    SimpleString::SimpleString(const SimpleString &original, std::pmr::memory_resource *const resource)
+            : resource_(resource) {
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+        hash_.store(original.hash_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+#endif
+        if (share(original)) return;
+
+        allocate(original.length_);
+        length_ = original.length_;
         std::copy(original.buffer_, original.buffer_ + length_, buffer_);
+        instrumentation::record(instrumentation::Event::COPY, length_ * sizeof(wchar_t));
     }
 
     SimpleString::SimpleString(SimpleString &&original) noexcept
-            : buffer_(original.buffer_), capacity_(original.capacity_), length_(original.length_) {
-        original.buffer_ = nullptr;
+            : buffer_(original.buffer_), capacity_(original.capacity_), length_(original.length_),
+              resource_(original.resource_), growth_policy_(original.growth_policy_) {
+        if (original.is_inline()) {
+            // inline buffer cannot be stolen so its content gets copied
+            buffer_ = inline_buffer_;
+            std::copy(original.inline_buffer_, original.inline_buffer_ + length_, inline_buffer_);
+        } else {
+            // original is left as a valid empty string
+            original.buffer_ = original.inline_buffer_;
+            original.capacity_ = inline_capacity;
+        }
+        original.length_ = 0;
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+        hash_.store(original.hash_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+#endif
     }
 
     /*
@@ -107,7 +366,7 @@ namespace lab {
      */
 
     SimpleString::~SimpleString() {
-        delete[] buffer_;
+        deallocate();
     }
 
     /*
@@ -122,9 +381,29 @@ namespace lab {
         return length_ == 0;
     }
 
+    const wchar_t *SimpleString::data() const noexcept {
+        return buffer_;
+    }
+
+    std::pmr::memory_resource *SimpleString::resource() const noexcept {
+        return resource_;
+    }
+
+    size_t SimpleString::capacity() const noexcept {
+        return capacity_;
+    }
+
+    SimpleString::GrowthPolicy SimpleString::growth_policy() const noexcept {
+        return growth_policy_;
+    }
+
     std::optional<size_t> SimpleString::index_of(const wchar_t character) const noexcept {
-        for (auto i = 0; i < length_; ++i) if (buffer_[i] == character) return i;
-        return std::optional<size_t>();
+        const auto length = length_;
+        const auto index = length < search::parallel_threshold()
+                ? simd::find_character(buffer_, length, character)
+                : search::find_character_parallel(buffer_, length, character);
+
+        return index == length ? std::optional<size_t>() : std::optional<size_t>(index);
     }
 
     std::optional<size_t> SimpleString::index_of(char character) const noexcept {
@@ -132,23 +411,67 @@ namespace lab {
     }
 
     std::optional<size_t> SimpleString::index_of(const SimpleString &other) const noexcept {
+        return index_of(SimpleStringView(other));
+    }
+
+    std::optional<size_t> SimpleString::index_of(const SimpleStringView other) const noexcept {
         if (other.empty()) return 0;
 
-        const auto length = length_, other_length = other.length_;
+        const auto length = length_, other_length = other.length();
         if (other_length > length) return std::optional<size_t>();
 
-        size_t first_impossible_index = length - other_length + 1;
-        for (size_t start_index = 0; start_index < first_impossible_index; ++start_index) {
-            size_t matched_characters = 0;
-            for (size_t index = start_index, other_index = 0; other_index < other_length;
-                    ++index, ++other_index) {
-                if (buffer_[index] == other.buffer_[other_index]) {
-                    if (++matched_characters == other_length) return start_index;
-                } else break;
-            }
-        }
+        const auto other_buffer = other.data();
+        search::Pattern pattern;
+        search::compile(pattern, other_buffer, other_length);
+        const auto index = length < search::parallel_threshold()
+                ? search::find(pattern, other_buffer, other_length, buffer_, length)
+                : search::find_parallel(pattern, other_buffer, other_length, buffer_, length);
 
-        return std::optional<size_t>();
+        return index == length ? std::optional<size_t>() : std::optional<size_t>(index);
+    }
+
+    std::optional<size_t> SimpleString::index_of(const wchar_t character, const size_t from) const noexcept {
+        return SimpleStringView(*this).index_of(character, from);
+    }
+
+    std::optional<size_t> SimpleString::index_of(const SimpleStringView other, const size_t from) const noexcept {
+        return SimpleStringView(*this).index_of(other, from);
+    }
+
+    std::optional<size_t> SimpleString::last_index_of(const wchar_t character) const noexcept {
+        return SimpleStringView(*this).last_index_of(character);
+    }
+
+    std::optional<size_t> SimpleString::last_index_of(const SimpleStringView other) const noexcept {
+        return SimpleStringView(*this).last_index_of(other);
+    }
+
+    size_t SimpleString::count(const wchar_t character) const noexcept {
+        return SimpleStringView(*this).count(character);
+    }
+
+    size_t SimpleString::count(const SimpleStringView other) const noexcept {
+        return SimpleStringView(*this).count(other);
+    }
+
+    search::Occurrences SimpleString::find_all(const SimpleStringView other) const & {
+        return SimpleStringView(*this).find_all(other);
+    }
+
+    split::Fields<split::CharacterDelimiter> SimpleString::split(const wchar_t delimiter) const & noexcept {
+        return SimpleStringView(*this).split(delimiter);
+    }
+
+    split::Fields<split::StringDelimiter> SimpleString::split(const SimpleStringView delimiter) const & {
+        return SimpleStringView(*this).split(delimiter);
+    }
+
+    split::Fields<split::AnyOfDelimiter> SimpleString::split_any(const SimpleStringView delimiters) const & {
+        return SimpleStringView(*this).split_any(delimiters);
+    }
+
+    split::Fields<split::LineDelimiter> SimpleString::lines() const & noexcept {
+        return SimpleStringView(*this).lines();
     }
 
     wchar_t SimpleString::at(const size_t index) const noexcept(false) {
@@ -159,6 +482,9 @@ namespace lab {
 
     wchar_t &SimpleString::at(const size_t index) noexcept(false) {
         check_index(index);
+        // the returned reference may be used to modify the buffer at any moment
+        make_unshareable();
+        make_hash_uncacheable();
 
         return buffer_[index];
     }
@@ -167,26 +493,48 @@ namespace lab {
         const auto length = length_;
         if (length != other.length_) return false;
 
-        for (size_t i = 0; i < length; ++i) if (buffer_[i] != other.buffer_[i]) return false;
-
-        return true;
+        return simd::mismatch(buffer_, other.buffer_, length) == length;
     }
 
     int SimpleString::compare(const SimpleString &other) const noexcept {
         const auto length = length_, other_length = other.length_;
 
         if (length == other_length) {
-            for (size_t i = 0; i < length; ++i) {
-                const auto character = buffer_[i], other_character = other.buffer_[i];
-                if (character != other_character) return character > other_character ? 1 : -1;
-            }
+            const auto index = simd::mismatch(buffer_, other.buffer_, length);
+            if (index == length) return 0;
 
-            return 0;
+            return buffer_[index] > other.buffer_[index] ? 1 : -1;
         }
 
         return length > other_length ? 1 : -1;
     }
 
+    size_t SimpleString::hash() const noexcept {
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+        // a hash which happens to be 0 is simply recomputed every time
+        if (hash_uncacheable_) return hashing::hash_of(buffer_, length_);
+
+        auto hash = hash_.load(std::memory_order_relaxed);
+        if (hash == 0) hash_.store(hash = hashing::hash_of(buffer_, length_), std::memory_order_relaxed);
+
+        return hash;
+#else
+        return hashing::hash_of(buffer_, length_);
+#endif
+    }
+
+    void SimpleString::to_utf8(std::string &out) const {
+        out.resize(utf8::encoded_size(buffer_, length_));
+        utf8::encode(buffer_, length_, out.data());
+    }
+
+    std::string SimpleString::to_utf8() const {
+        std::string out;
+        to_utf8(out);
+
+        return out;
+    }
+
     /*
      * Modifying public methods
      */
@@ -195,9 +543,24 @@ namespace lab {
         resize_to(length_);
     }
 
+    void SimpleString::reserve(const size_t capacity) {
+        if (capacity_ < capacity) resize_to(capacity);
+    }
+
+    void SimpleString::clear() noexcept {
+        discard_shared_buffer();
+        invalidate_hash();
+        length_ = 0;
+    }
+
+    void SimpleString::set_growth_policy(const GrowthPolicy growth_policy) noexcept {
+        growth_policy_ = growth_policy;
+    }
+
     void SimpleString::append(const wchar_t character) {
         const auto length = length_, new_length = length + 1;
         ensure_capacity(new_length);
+        invalidate_hash();
 
         buffer_[length] = character;
         length_ = new_length;
@@ -208,16 +571,29 @@ namespace lab {
     }
 
     void SimpleString::append(const SimpleString &other) {
-        const auto length = length_, other_length = other.length_, new_length = length + other_length;
+        append(SimpleStringView(other));
+    }
+
+    void SimpleString::append(const SimpleStringView other) {
+        const auto length = length_, other_length = other.length(), new_length = length + other_length;
+
+        // the view may refer to this string's buffer which can be reallocated
+        auto other_buffer = other.data();
+        const auto aliased = other_buffer >= buffer_ && other_buffer < buffer_ + length;
+        const auto offset = aliased ? size_t(other_buffer - buffer_) : 0;
+
         ensure_capacity(new_length);
+        invalidate_hash();
 
-        const auto other_buffer = other.buffer_;
-        std::copy(other_buffer, other_buffer + length, buffer_ + length);
+        if (aliased) other_buffer = buffer_ + offset;
+        std::copy(other_buffer, other_buffer + other_length, buffer_ + length);
         length_ = new_length;
     }
 
     void SimpleString::set(const size_t index, const wchar_t character) {
         check_index(index);
+        detach();
+        invalidate_hash();
 
         buffer_[index] = character;
     }
@@ -228,41 +604,102 @@ namespace lab {
 
     SimpleString &SimpleString::operator=(const SimpleString &original) {
         if (this != &original) {
+            // the contents may be lost if the allocation fails so the hash is only copied along with them
+            invalidate_hash();
+            if constexpr (copy_on_write) {
+                // the strings already share the buffer
+                if (!original.is_inline() && buffer_ == original.buffer_) return *this;
+
+                // sharing the original's buffer is cheaper than copying into the current one
+                const auto current_buffer = buffer_;
+                const auto current_capacity = capacity_;
+                const auto was_inline = is_inline();
+                if (share(original)) {
+                    if (!was_inline) release_heap_buffer(resource_, current_buffer, current_capacity);
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+                    hash_.store(original.hash_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+#endif
+                    return *this;
+                }
+
+                // current heap buffer may be shared so it is released rather than overwritten
+                discard_shared_buffer();
+            }
+
             const auto length = original.length_;
-            if (length != length_) {
+            if (length > capacity_) {
                 // a new buffer should be allocated
 
                 // free current buffer
-                delete[] buffer_;
+                deallocate();
 
                 // it is recommended to keep defaults in case something fails later
-                buffer_ = nullptr;
-                capacity_ = length_ = 0;
+                buffer_ = inline_buffer_;
+                capacity_ = inline_capacity;
+                length_ = 0;
 
                 // create needed copies and assign them to the fields
-                buffer_ = new wchar_t[length];
-                capacity_ = length_ = length;
+                allocate(length);
             }
 
             std::copy(original.buffer_, original.buffer_ + length, buffer_);
+            length_ = length;
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+            hash_.store(original.hash_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+#endif
+            instrumentation::record(instrumentation::Event::COPY, length * sizeof(wchar_t));
         }
 
         return *this;
     }
 
-    SimpleString &SimpleString::operator=(SimpleString &&original) noexcept {
+    SimpleString &SimpleString::operator=(SimpleString &&original) {
         if (this != &original) {
-            // free current buffer
-            delete[] buffer_;
+            // a buffer of another resource cannot be adopted as this string keeps its resource
+            if (!original.is_inline() && *resource_ != *original.resource_) return *this = original;
+
+            // inline original is copied so the current buffer is reused as long as it is not shared
+            if (original.is_inline()) discard_shared_buffer();
+            if (original.is_inline() && !is_inline()) {
+                std::copy(original.inline_buffer_, original.inline_buffer_ + original.length_, buffer_);
+                length_ = std::exchange(original.length_, 0);
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+                hash_.store(original.hash_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+                hash_uncacheable_ = false;
+#endif
+                return *this;
+            }
 
-            buffer_ = std::exchange(original.buffer_, nullptr);
-            capacity_ = std::exchange(original.capacity_, 0);
+            // free current buffer
+            deallocate();
+
+            if (original.is_inline()) {
+                // inline buffer cannot be stolen so its content gets copied
+                buffer_ = inline_buffer_;
+                capacity_ = inline_capacity;
+                std::copy(original.inline_buffer_, original.inline_buffer_ + original.length_, inline_buffer_);
+            } else {
+                buffer_ = std::exchange(original.buffer_, original.inline_buffer_);
+                capacity_ = std::exchange(original.capacity_, inline_capacity);
+            }
             length_ = std::exchange(original.length_, 0);
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+            hash_.store(original.hash_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            hash_uncacheable_ = false;
+#endif
         }
 
         return *this;
     }
 
+    /*
+     * Conversion operators
+     */
+
+    SimpleString::operator SimpleStringView() const noexcept {
+        return {buffer_, length_};
+    }
+
     /*
      * Indexed access operators
      */
@@ -276,44 +713,9 @@ namespace lab {
     }
 
     /*
-     * Modification operators
+     * Comparison operators
      */
 
-    SimpleString SimpleString::operator+(const SimpleString &other) const {
-        const auto length = length_, other_length = other.length_;
-
-        if (length == 0) return other_length == 0 ? SimpleString() : other /* explicit copy */;
-        if (other_length == 0) return *this /* explicit copy */;
-
-        SimpleString result(length + other_length);
-        {
-            // reuse `buffer` for `this->buffer_`
-            auto buffer = buffer_, result_buffer = result.buffer_;
-            std::copy(buffer, buffer + length, result_buffer);
-            // reuse `buffer` for `other.buffer_`
-            buffer = other.buffer_;
-            std::copy(buffer, buffer + other_length, result_buffer + length);
-        }
-
-        return result;
-    }
-
-    SimpleString SimpleString::operator*(const size_t count) const {
-        const auto length = length_;
-        if (length == 0) return SimpleString();
-
-        if (count > SIZE_MAX / length) throw std::overflow_error("The resulting string is too big");
-
-        SimpleString result(length * count);
-        {
-            const auto start = buffer_, end = buffer_ + length;
-            auto result_buffer = result.buffer_;
-            for (size_t i = 0; i < count; ++i, result_buffer += length) std::copy(start, end, result_buffer);
-        }
-
-        return result;
-    }
-
     bool SimpleString::operator==(const SimpleString &other) const noexcept {
         return equals(other);
     }
@@ -339,35 +741,352 @@ namespace lab {
     }
 
 #ifdef __cpp_lib_three_way_comparison
-    [[nodiscard]] bool operator<=>(const SimpleString &other) const noexcept {
-        return compare(other);
+    std::strong_ordering SimpleString::operator<=>(const SimpleString &other) const noexcept {
+        return compare(other) <=> 0;
     }
 #endif
 
-    std::ostream &operator<<(std::ostream &out, const SimpleString &string) {
-        for (size_t i = 0; i < string.length_; ++i) out << char(string.buffer_[i]);
+    /*
+     * Lazy string expressions
+     */
 
-        return out;
+    /**
+     * @brief Number of characters up to which the filled prefix is doubled,
+     * the rest is filled with copies of the prefix which thus stays in the cache
+     */
+    static constexpr size_t fill_block = size_t(1) << 14u;
+
+    /**
+     * @brief Number of characters copied by a single task of the parallel fill
+     */
+    static constexpr size_t parallel_fill_chunk = size_t(1) << 20u;
+
+    /**
+     * @brief Fills the part of the buffer with copies of its first characters
+     *
+     * @param destination buffer whose first {@code block} characters are filled
+     * @param block number of the copied characters, it should be a multiple of the period
+     * @param begin index of the first character of the part, it should be a multiple of {@code block}
+     * @param end index past the last character of the part
+     */
+    static void copy_prefix(wchar_t *const destination, const size_t block, const size_t begin, const size_t end) {
+        for (auto position = begin; position < end; position += block)
+            std::copy(destination, destination + std::min(block, end - position), destination + position);
+    }
+
+    void expression::fill_periodic(wchar_t *const destination, const size_t period, const size_t length,
+                                   ThreadPool &pool) {
+        // the prefix is doubled so that short periods do not need a copy per repetition
+        const auto block = std::min(std::max(fill_block / period, size_t(1)) * period, length);
+        for (auto filled = period; filled < block;) {
+            // copying from the beginning to a multiple of the period keeps the content periodic
+            const auto count = std::min(filled, block - filled);
+            std::copy(destination, destination + count, destination + filled);
+            filled += count;
+        }
+
+        if (length < parallel_fill_threshold || pool.concurrency() == 1) {
+            copy_prefix(destination, block, block, length);
+            return;
+        }
+
+        // every chunk starts at a multiple of the block so it consists of its copies
+        const auto chunk = std::max(parallel_fill_chunk / block, size_t(1)) * block;
+        copy_prefix(destination, block, block, std::min(chunk, length));
+        try {
+            pool.run((length - 1) / chunk, [destination, block, chunk, length](const size_t task) {
+                const auto begin = (task + 1) * chunk;
+                copy_prefix(destination, block, begin, std::min(begin + chunk, length));
+            });
+        } catch (...) {
+            // the copies do not throw so the pool itself has failed, copying the chunks again is harmless
+            copy_prefix(destination, block, chunk, length);
+        }
+    }
+
+    void expression::fill_periodic(wchar_t *const destination, const size_t period, const size_t length) {
+        fill_periodic(destination, period, length, ThreadPool::global());
+    }
+
+    std::ostream &operator<<(std::ostream &out, const SimpleString &string) {
+        return out << SimpleStringView(string);
     }
 
     std::wostream &operator<<(std::wostream &out, const SimpleString &string) {
-        for (size_t i = 0; i < string.length_; ++i) out << string.buffer_[i];
+        return out << SimpleStringView(string);
+    }
 
-        return out;
+    /**
+     * @brief Accessor of the get area of any stream buffer
+     *
+     * @note the get area is protected, still a pointer to its member functions may be formed in a derived class
+     */
+    template<typename TChar, typename TTraits>
+    class GetArea : public std::basic_streambuf<TChar, TTraits> {
+        using Buffer = std::basic_streambuf<TChar, TTraits>;
+
+    public:
+        static TChar *begin(Buffer &buffer) {
+            return (buffer.*&GetArea::gptr)();
+        }
+
+        static TChar *end(Buffer &buffer) {
+            return (buffer.*&GetArea::egptr)();
+        }
+
+        static void skip(Buffer &buffer, const size_t count) {
+            (buffer.*&GetArea::gbump)(int(count));
+        }
+    };
+
+    template<typename TTraits, typename TChar>
+    static inline const TChar *find_character(const TChar *const begin, const TChar *const end, const TChar character) {
+        const auto found = TTraits::find(begin, size_t(end - begin), character);
+        return found == nullptr ? end : found;
     }
 
-    template<typename T>
-    static bool is_word_terminator(const T character) {
-        return character == EOF || character == '\n' || character == '\r';
+    /**
+     * @brief Private methods of {@link SimpleString} appending the extracted characters in place
+     */
+    struct Extension {
+        wchar_t *(SimpleString::*extend)(size_t);
+        void (SimpleString::*truncate)(size_t) noexcept;
+    };
+
+    /**
+     * @brief Appends the characters extracted from a stream buffer to the string
+     */
+    template<typename TChar>
+    class Appender;
+
+    template<>
+    class Appender<wchar_t> {
+        SimpleString &string_;
+        const Extension extension_;
+
+    public:
+        Appender(SimpleString &string, const Extension extension) noexcept : string_(string), extension_(extension) {}
+
+        void operator()(const wchar_t *const begin, const wchar_t *const end) {
+            std::copy(begin, end, (string_.*extension_.extend)(size_t(end - begin)));
+        }
+
+        void finish() const noexcept {}
+    };
+
+    /**
+     * @brief Decodes the UTF-8 bytes extracted from a narrow stream buffer
+     *
+     * @note a sequence split between two ranges of bytes is kept until the rest of it is extracted
+     */
+    template<>
+    class Appender<char> {
+        SimpleString &string_;
+        const Extension extension_;
+
+        /**
+         * @brief Leading bytes of the incomplete sequence at the end of the last range
+         */
+        char pending_[4]{};
+
+        size_t pending_size_ = 0;
+
+        static size_t sequence_length(const char lead) noexcept {
+            const auto byte = static_cast<unsigned char>(lead);
+            return byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+        }
+
+        /**
+         * @brief Gets the number of bytes of the incomplete sequence ending the range
+         */
+        static size_t incomplete_length(const char *const begin, const char *const end) noexcept {
+            const auto size = std::min(size_t(end - begin), size_t(3));
+            for (size_t back = 1; back <= size; ++back) {
+                const auto byte = static_cast<unsigned char>(end[-std::ptrdiff_t(back)]);
+                if ((byte & 0xC0u) == 0x80u) continue;
+
+                return sequence_length(char(byte)) > back ? back : 0;
+            }
+
+            return 0;
+        }
+
+        void decode(const char *const bytes, const size_t size) {
+            if (size == 0) return;
+
+            utf8::decode(bytes, size, (string_.*extension_.extend)(utf8::decoded_length(bytes, size)));
+        }
+
+    public:
+        Appender(SimpleString &string, const Extension extension) noexcept : string_(string), extension_(extension) {}
+
+        void operator()(const char *begin, const char *const end) {
+            if (pending_size_ != 0) {
+                const auto missing = std::min(sequence_length(pending_[0]) - pending_size_, size_t(end - begin));
+                std::copy_n(begin, missing, pending_ + pending_size_);
+                pending_size_ += missing;
+                begin += missing;
+                if (pending_size_ < sequence_length(pending_[0])) return;
+
+                decode(pending_, pending_size_);
+                pending_size_ = 0;
+            }
+
+            const auto incomplete = incomplete_length(begin, end);
+            decode(begin, size_t(end - begin) - incomplete);
+            std::copy(end - incomplete, end, pending_);
+            pending_size_ = incomplete;
+        }
+
+        /**
+         * @brief Checks that no sequence is left incomplete
+         *
+         * @throws {@link utf8::DecodingError} if the extracted bytes end in the middle of a sequence
+         */
+        void finish() const {
+            if (pending_size_ != 0) throw utf8::DecodingError("Truncated UTF-8 sequence", 0);
+        }
+    };
+
+    /**
+     * @brief Extracts the characters of the stream buffer until a terminator or the end of the stream
+     *
+     * @param buffer stream buffer to read from
+     * @param find finds the first terminator in the given range of characters (or returns the range's end)
+     * @param consume called for each extracted range of characters
+     * @return number of extracted characters and whether the end of the stream was reached
+     * @note the terminator is left in the stream buffer
+     */
+    template<typename TChar, typename TTraits, typename TFind, typename TConsume>
+    static std::pair<size_t, bool> extract(std::basic_streambuf<TChar, TTraits> &buffer,
+                                           const TFind find, const TConsume consume) {
+        using Area = GetArea<TChar, TTraits>;
+        // gbump() takes an int so a huge get area is consumed in several chunks
+        constexpr size_t max_chunk = INT_MAX;
+
+        size_t extracted = 0;
+        while (true) {
+            auto begin = Area::begin(buffer), end = Area::end(buffer);
+            if (begin == end) {
+                const auto next = buffer.sgetc();
+                if (TTraits::eq_int_type(next, TTraits::eof())) return {extracted, true};
+
+                begin = Area::begin(buffer);
+                end = Area::end(buffer);
+                if (begin == end) {
+                    // unbuffered stream buffer provides a single character at a time
+                    const auto character = TTraits::to_char_type(next);
+                    if (find(&character, &character + 1) != &character + 1) return {extracted, false};
+
+                    consume(&character, &character + 1);
+                    buffer.sbumpc();
+                    ++extracted;
+                    continue;
+                }
+            }
+
+            if (size_t(end - begin) > max_chunk) end = begin + max_chunk;
+            const auto stop = find(begin, end);
+            const auto count = size_t(stop - begin);
+            if (count != 0) {
+                consume(begin, stop);
+                Area::skip(buffer, count);
+                extracted += count;
+            }
+            if (stop != end) return {extracted, false};
+        }
     }
 
-    std::istream &operator>>(std::istream &in, SimpleString &string) {
-        while (!is_word_terminator(in.peek())) string.append(char(in.get()));
+    template<typename TChar, typename TTraits>
+    static std::basic_istream<TChar, TTraits> &extract_word(std::basic_istream<TChar, TTraits> &in,
+                                                            SimpleString &string, const Extension extension) {
+        const typename std::basic_istream<TChar, TTraits>::sentry sentry(in, true);
+        if (!sentry) return in;
+
+        const auto length = string.length();
+        auto state = std::ios_base::goodbit;
+        try {
+            Appender<TChar> append(string, extension);
+            const auto [extracted, ended] = extract(
+                    *in.rdbuf(),
+                    [](const TChar *const begin, const TChar *const end) {
+                        // two vectorized scans are faster than a single character-by-character one
+                        const auto line_feed = find_character<TTraits>(begin, end, TChar('\n'));
+                        return find_character<TTraits>(begin, line_feed, TChar('\r'));
+                    },
+                    [&append](const TChar *const begin, const TChar *const end) { append(begin, end); }
+            );
+            append.finish();
+            if (ended) state |= std::ios_base::eofbit;
+        } catch (const utf8::DecodingError &) {
+            (string.*extension.truncate)(length);
+            state |= std::ios_base::failbit;
+        } catch (...) {
+            in.setstate(std::ios_base::badbit);
+            if (in.exceptions() & std::ios_base::badbit) throw;
+        }
+        in.setstate(state);
+
         return in;
     }
 
-    std::wistream &operator>>(std::wistream &in, SimpleString &string) {
-        while (!is_word_terminator(in.peek())) string.append(wchar_t(in.get()));
+    template<typename TChar, typename TTraits>
+    static std::basic_istream<TChar, TTraits> &extract_line(std::basic_istream<TChar, TTraits> &in,
+                                                            SimpleString &line, const TChar delimiter,
+                                                            const Extension extension) {
+        const typename std::basic_istream<TChar, TTraits>::sentry sentry(in, true);
+        if (!sentry) return in;
+
+        const auto length = line.length();
+        auto state = std::ios_base::goodbit;
+        try {
+            Appender<TChar> append(line, extension);
+            auto [extracted, ended] = extract(
+                    *in.rdbuf(),
+                    [delimiter](const TChar *const begin, const TChar *const end) {
+                        return find_character<TTraits>(begin, end, delimiter);
+                    },
+                    [&append](const TChar *const begin, const TChar *const end) { append(begin, end); }
+            );
+            append.finish();
+            if (ended) state |= std::ios_base::eofbit;
+            else {
+                // the delimiter is extracted but not stored
+                in.rdbuf()->sbumpc();
+                ++extracted;
+            }
+            if (extracted == 0) state |= std::ios_base::failbit;
+        } catch (const utf8::DecodingError &) {
+            (line.*extension.truncate)(length);
+            state |= std::ios_base::failbit;
+        } catch (...) {
+            in.setstate(std::ios_base::badbit);
+            if (in.exceptions() & std::ios_base::badbit) throw;
+        }
+        in.setstate(state);
+
         return in;
     }
+
+    std::istream &operator>>(std::istream &in, SimpleString &string) {
+        return extract_word(in, string, {&SimpleString::extend, &SimpleString::truncate});
+    }
+
+    std::wistream &operator>>(std::wistream &in, SimpleString &string) {
+        return extract_word(in, string, {&SimpleString::extend, &SimpleString::truncate});
+    }
+
+    std::istream &read_line(std::istream &in, SimpleString &line, const char delimiter) {
+        // the buffer is kept so that its capacity is reused
+        line.clear();
+
+        return extract_line(in, line, delimiter, {&SimpleString::extend, &SimpleString::truncate});
+    }
+
+    std::wistream &read_line(std::wistream &in, SimpleString &line, const wchar_t delimiter) {
+        // the buffer is kept so that its capacity is reused
+        line.clear();
+
+        return extract_line(in, line, delimiter, {&SimpleString::extend, &SimpleString::truncate});
+    }
 }
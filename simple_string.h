@@ -7,19 +7,123 @@
 #include <ostream>
 #include <istream>
 #include <optional>
+#include <compare>
+#include <concepts>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <memory_resource>
+#include <string>
+
+#include "simple_string_view.h"
+#include "utf8.h"
+#include "instrumentation.h"
 
 namespace lab {
 
+    class SimpleString;
+
+    class ThreadPool;
+
+    template<typename TLeft, typename TRight>
+    class Concatenation;
+
+    template<typename TOperand>
+    class Repetition;
+
+    /**
+     * @brief Checks if the type is a lazy string expression (i.e. result of {@code operator+} or {@code operator*})
+     */
+    template<typename T>
+    struct is_string_expression : std::false_type {};
+
+    template<typename TLeft, typename TRight>
+    struct is_string_expression<Concatenation<TLeft, TRight>> : std::true_type {};
+
+    template<typename TOperand>
+    struct is_string_expression<Repetition<TOperand>> : std::true_type {};
+
+    template<typename T>
+    concept StringExpression = is_string_expression<T>::value;
+
+    /**
+     * @brief Type which can be an operand of a lazy string expression
+     */
+    template<typename T>
+    concept StringOperand = std::same_as<T, SimpleString> || std::same_as<T, SimpleStringView> || StringExpression<T>;
+
     /**
      * @brief Simple implementation of a
      */
     class SimpleString {
+    public:
+
+        /**
+         * @brief Number of characters which can be stored inside the string object itself without heap allocation
+         */
+        static constexpr size_t inline_capacity = 16;
+
+        /**
+         * @brief Whether copies of heap-allocated strings share their buffer until one of them is modified
+         *
+         * @note this is enabled by defining {@code LAB_SIMPLE_STRING_COPY_ON_WRITE}
+         */
+#ifdef LAB_SIMPLE_STRING_COPY_ON_WRITE
+        static constexpr bool copy_on_write = true;
+#else
+        static constexpr bool copy_on_write = false;
+#endif
+
+        /**
+         * @brief Whether the string remembers its hash until it is modified
+         *
+         * @note this is enabled by defining {@code LAB_SIMPLE_STRING_CACHE_HASH}
+         */
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+        static constexpr bool cache_hash = true;
+#else
+        static constexpr bool cache_hash = false;
+#endif
+
+        /**
+         * @brief Way in which the buffer grows when appended characters do not fit into it
+         */
+        enum class GrowthPolicy : unsigned char {
+            /**
+             * @brief The capacity is multiplied by 1.5
+             */
+            ONE_AND_A_HALF,
+            /**
+             * @brief The capacity is doubled
+             */
+            DOUBLE,
+            /**
+             * @brief The capacity is multiplied by 1.5 and buffers of at least a page are rounded up to whole pages
+             */
+            PAGE_ROUNDED
+        };
+
+        /**
+         * @brief Growth policy of the created strings
+         *
+         * @note this is set by defining {@code LAB_SIMPLE_STRING_GROWTH_POLICY} to the name of the policy
+         */
+#ifdef LAB_SIMPLE_STRING_GROWTH_POLICY
+        static constexpr GrowthPolicy default_growth_policy = GrowthPolicy::LAB_SIMPLE_STRING_GROWTH_POLICY;
+#else
+        static constexpr GrowthPolicy default_growth_policy = GrowthPolicy::ONE_AND_A_HALF;
+#endif
+
     protected:
 
         /**
          * @brief Character buffer, its length is at least {@code length_}
          *
          * @note stored string is not 0-terminated
+         * @note this points either to {@code inline_buffer_} or to a heap-allocated buffer
+         * which may be shared with other strings if {@link #copy_on_write} is enabled
          */
         wchar_t *buffer_;
 
@@ -32,6 +136,34 @@ namespace lab {
          */
         length_;
 
+        /**
+         * @brief Buffer used for short strings so that they do not require heap allocation
+         */
+        wchar_t inline_buffer_[inline_capacity];
+
+        /**
+         * @brief Memory resource used for all heap allocations of this string
+         */
+        std::pmr::memory_resource *resource_;
+
+        /**
+         * @brief Way in which {@code buffer_} grows
+         */
+        GrowthPolicy growth_policy_ = default_growth_policy;
+
+#ifdef LAB_SIMPLE_STRING_CACHE_HASH
+        /**
+         * @brief Hash of the characters or {@code 0} if it has not been computed since the last modification
+         */
+        mutable std::atomic<size_t> hash_{0};
+
+        /**
+         * @brief Whether a mutable reference to a character has been given out since the last modification
+         * so that the hash may change at any moment and is not cached
+         */
+        bool hash_uncacheable_ = false;
+#endif
+
         /*
          * Protected constructor
          */
@@ -40,17 +172,20 @@ namespace lab {
          * @brief Creates a new simple string of given length with no extra buffer space
          *
          * @param length length of the created string
+         * @param resource memory resource used by the created string
          */
-        explicit SimpleString(size_t length);
+        explicit SimpleString(size_t length, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
         /**
          * @brief Creates a new simple string of given length and capacity
          *
          * @param length length of the created string
          * @param capacity capacity of the created string
+         * @param resource memory resource used by the created string
          * @throws if {@code capacity_} is less than {@code length_}
          */
-        explicit SimpleString(size_t length, size_t capacity);
+        explicit SimpleString(size_t length, size_t capacity,
+                              std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
         /*
          * Internal methods
@@ -63,6 +198,58 @@ namespace lab {
          */
         void check_index(size_t index) const noexcept(false);
 
+        /**
+         * @brief Checks if this string currently stores its characters in {@code inline_buffer_}
+         *
+         * @return {@code true} if the characters are stored inline and {@code false} if they are stored on heap
+         */
+        [[nodiscard]] bool is_inline() const noexcept;
+
+        /**
+         * @brief Points {@code buffer_} to the storage of at least given capacity
+         * using {@code inline_buffer_} whenever it is enough
+         *
+         * @param capacity minimal capacity of the storage
+         * @note this does not free the previous buffer
+         */
+        void allocate(size_t capacity);
+
+        /**
+         * @brief Frees {@code buffer_} if it is heap-allocated
+         *
+         * @note this does not update any fields
+         */
+        void deallocate() noexcept;
+
+        /**
+         * @brief Makes this string share the heap buffer of the original one if {@link #copy_on_write} is enabled
+         * and both strings use equal memory resources
+         *
+         * @param original string whose buffer should be shared
+         * @return {@code true} if the buffer is now shared and {@code false} if it should be copied
+         * @note this does not free the previous buffer
+         */
+        bool share(const SimpleString &original) noexcept;
+
+        /**
+         * @brief Ensures that the heap buffer of this string is not shared with other strings copying it if needed
+         */
+        void detach();
+
+        /**
+         * @brief Detaches the buffer and prevents it from being shared
+         * as a mutable reference to one of its characters is being given out
+         */
+        void make_unshareable();
+
+        /**
+         * @brief Releases the heap buffer if it is shared with other strings making this string empty and inline
+         * as the buffer's content is about to be overwritten
+         *
+         * @note a buffer owned by this string alone is kept so that its capacity can be reused
+         */
+        void discard_shared_buffer() noexcept;
+
         /**
          * @brief Ensures that this string's capacity is not less than given
          *
@@ -77,6 +264,47 @@ namespace lab {
          */
         void resize_to(size_t new_capacity);
 
+        /**
+         * @brief Calculates the new capacity of a buffer based on the current one and the minimal required
+         *
+         * @param growth_policy way in which the buffer grows
+         * @param current_capacity current capacity of the buffer
+         * @param required_capacity minimal required capacity of the buffer
+         * @param character_size size of the buffer's character in bytes
+         * @param header size of the header allocated before the characters in bytes
+         * @return new capacity of the buffer
+         * @throws {@code std::overflow_error} if the buffer cannot grow anymore
+         * @note this is shared with {@link CompactString} so that both strings grow in the same way
+         */
+        static size_t calculate_new_capacity(GrowthPolicy growth_policy, size_t current_capacity,
+                                             size_t required_capacity, size_t character_size, size_t header);
+
+        /**
+         * @brief Forgets the cached hash as the characters are being modified
+         */
+        void invalidate_hash() noexcept;
+
+        /**
+         * @brief Forgets the cached hash and stops caching it
+         * as a mutable reference to one of the characters is being given out
+         */
+        void make_hash_uncacheable() noexcept;
+
+        /**
+         * @brief Extends this string by the given number of characters which should then be written by the caller
+         *
+         * @param count number of added characters
+         * @return pointer to the first of the added characters
+         */
+        wchar_t *extend(size_t count);
+
+        /**
+         * @brief Shortens this string to the given length keeping its buffer
+         *
+         * @param length new length of this string, it should not be greater than the current one
+         */
+        void truncate(size_t length) noexcept;
+
     public:
 
         /*
@@ -88,27 +316,70 @@ namespace lab {
          */
         SimpleString();
 
+        /**
+         * @brief Creates a new empty string which will allocate its buffers from the given memory resource
+         *
+         * @param resource memory resource used by the created string, it should outlive the string
+         */
+        explicit SimpleString(std::pmr::memory_resource *resource);
+
         /**
          * @brief Creates a new string of given size with its content set to {@ode #symbol}
          *
          * @param length length of the created string
          * @param symbol symbol to fill the string with
+         * @param resource memory resource used by the created string
          */
-        SimpleString(size_t length, wchar_t symbol);
+        SimpleString(size_t length, wchar_t symbol,
+                     std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
         /**
          * @brief Creates a new string based on the given C-string (0-terminated dynamic {@code char}-array)
          *
-         * @param wide_c_string original string to be copied into the created one
+         * @param c_string original UTF-8 string to be decoded into the created one
+         * @param resource memory resource used by the created string
+         * @throws {@link utf8::DecodingError} if the C-string is not valid UTF-8
          */
-        explicit SimpleString(char const *wide_c_string);
+        explicit SimpleString(char const *c_string,
+                              std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
         /**
          * @brief Creates a new string based on the given wide-C-string (0-terminated dynamic {@code wchar_t}-array)
          *
          * @param wide_c_string original string to be copied into the created one
+         * @param resource memory resource used by the created string
          */
-        explicit SimpleString(wchar_t const *wide_c_string);
+        explicit SimpleString(wchar_t const *wide_c_string,
+                              std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+        /**
+         * @brief Creates a new string with the characters referred by the given view
+         *
+         * @param view view whose characters should be copied into the created string
+         * @param resource memory resource used by the created string
+         */
+        explicit SimpleString(SimpleStringView view,
+                              std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+        /**
+         * @brief Copies the original string into the created one which uses the given memory resource
+         *
+         * @param original string which should be copied into the created one
+         * @param resource memory resource used by the created string
+         */
+        SimpleString(const SimpleString &original, std::pmr::memory_resource *resource);
+
+        /**
+         * @brief Creates a new string decoding the given UTF-8 bytes
+         *
+         * @param bytes UTF-8 bytes, they may contain {@code '\0'}
+         * @param size number of bytes
+         * @param resource memory resource used by the created string
+         * @return created string whose buffer has exactly the decoded length
+         * @throws {@link utf8::DecodingError} if the bytes are not valid UTF-8
+         */
+        [[nodiscard]] static SimpleString from_utf8(const char *bytes, size_t size,
+                                                    std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
         /*
          * Special constructors
@@ -118,7 +389,9 @@ namespace lab {
          * @brief Copies the original string into the created one
          *
          * @param original string which should be copied into the created one
-         * @note the created string will have no extra buffer space
+         * @note the created string will have no extra buffer space unless it shares the original's buffer
+         * @note as with {@code std::pmr} containers the memory resource is not copied,
+         * the created string uses the default one, the same goes for the growth policy
          */
         SimpleString(const SimpleString &original);
 
@@ -126,15 +399,27 @@ namespace lab {
          * @brief Moves the original string into the created one
          *
          * @param original string which should be moved into the created one
+         * @note the created string takes over the original's memory resource and growth policy
          */
         SimpleString(SimpleString &&original) noexcept;
 
+        /**
+         * @brief Materializes the lazy string expression into the created string
+         *
+         * @param expression expression whose result should be stored in the created string
+         * @param resource memory resource used by the created string
+         * @note the created string is allocated exactly once and has no extra buffer space
+         */
+        template<StringExpression TExpression>
+        SimpleString(const TExpression &expression, // NOLINT(google-explicit-constructor): expressions are strings
+                     std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
         /*
          * Public destructor
          */
 
         /**
-         * @brief Destroys this string freeing all dynamically allocated memory (i.e. {@code buffer_})
+         * @brief Destroys this string freeing all dynamically allocated memory (i.e. {@code buffer_} if it is on heap)
          */
         ~SimpleString();
 
@@ -156,11 +441,42 @@ namespace lab {
          */
         [[nodiscard]] bool empty() const noexcept;
 
+        /**
+         * @brief Gets the pointer to this string's characters
+         *
+         * @return pointer to the first of {@link #length()} characters of this string
+         * @note the characters are not 0-terminated and the pointer is invalidated by any modification of this string
+         */
+        [[nodiscard]] const wchar_t *data() const noexcept;
+
+        /**
+         * @brief Gets the memory resource used by this string
+         *
+         * @return memory resource used for all heap allocations of this string
+         */
+        [[nodiscard]] std::pmr::memory_resource *resource() const noexcept;
+
+        /**
+         * @brief Gets the number of characters this string can hold without reallocating its buffer
+         *
+         * @return capacity of this string, it is never less than {@link #inline_capacity}
+         */
+        [[nodiscard]] size_t capacity() const noexcept;
+
+        /**
+         * @brief Gets the way in which this string's buffer grows
+         *
+         * @return growth policy of this string
+         */
+        [[nodiscard]] GrowthPolicy growth_policy() const noexcept;
+
         /**
          * @brief Gets an index of the first occurrence of the given wide character
          *
          * @param character wide character to find
          * @return optional of wide character's index if it was found or an empty optional otherwise
+         * @note strings of at least {@link search::parallel_threshold()} characters are searched
+         * in parallel by {@link ThreadPool::global()}
          */
         [[nodiscard]] std::optional<size_t> index_of(wchar_t character) const noexcept;
 
@@ -180,6 +496,128 @@ namespace lab {
          */
         [[nodiscard]] std::optional<size_t> index_of(const SimpleString &other) const noexcept;
 
+        /**
+         * @brief Gets an index of the first occurrence of the given string view
+         *
+         * @param other string view to find
+         * @return optional of view's index if it was found or an empty optional otherwise
+         * @note strings of at least {@link search::parallel_threshold()} characters are searched
+         * in parallel by {@link ThreadPool::global()}
+         */
+        [[nodiscard]] std::optional<size_t> index_of(SimpleStringView other) const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the given wide character at or after the given index
+         *
+         * @param character wide character to find
+         * @param from index from which to search, it may exceed this string's length
+         * @return optional of wide character's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> index_of(wchar_t character, size_t from) const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the given string at or after the given index
+         *
+         * @param other string to find
+         * @param from index from which to search, it may exceed this string's length
+         * @return optional of string's index if it was found or an empty optional otherwise
+         * @note strings of at least {@link search::parallel_threshold()} characters are searched
+         * in parallel by {@link ThreadPool::global()}
+         */
+        [[nodiscard]] std::optional<size_t> index_of(SimpleStringView other, size_t from) const noexcept;
+
+        /**
+         * @brief Gets an index of the last occurrence of the given wide character
+         *
+         * @param character wide character to find
+         * @return optional of wide character's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> last_index_of(wchar_t character) const noexcept;
+
+        /**
+         * @brief Gets an index of the last occurrence of the given string
+         *
+         * @param other string to find
+         * @return optional of string's index if it was found or an empty optional otherwise,
+         * an empty string is found at this string's length
+         */
+        [[nodiscard]] std::optional<size_t> last_index_of(SimpleStringView other) const noexcept;
+
+        /**
+         * @brief Counts the occurrences of the given wide character
+         *
+         * @param character wide character to count
+         * @return number of the character's occurrences
+         */
+        [[nodiscard]] size_t count(wchar_t character) const noexcept;
+
+        /**
+         * @brief Counts the occurrences of the given string including overlapping ones
+         *
+         * @param other string to count
+         * @return number of the string's occurrences, an empty string occurs {@code length() + 1} times
+         */
+        [[nodiscard]] size_t count(SimpleStringView other) const noexcept;
+
+        /**
+         * @brief Gets a lazy range of the positions of all occurrences of the given string including overlapping ones
+         *
+         * @param other string to find, it is copied into the range
+         * @return range of the occurrences' indices in increasing order
+         * @note this does not allocate unless the needle is longer than {@link search::short_needle_length}, the range refers to this string's buffer which should not be reallocated
+         */
+        [[nodiscard]] search::Occurrences find_all(SimpleStringView other) const &;
+
+        /**
+         * @brief Deleted as the range would refer to the buffer of a destroyed temporary
+         */
+        search::Occurrences find_all(SimpleStringView other) const && = delete;
+
+        /**
+         * @brief Gets a lazy range of the parts of this string separated by the given character
+         *
+         * @param delimiter character separating the parts
+         * @return range of views of the parts, there is one more of them than the delimiters
+         * @note the delimiter is found by the vectorized character search and no part is copied
+         */
+        [[nodiscard]] split::Fields<split::CharacterDelimiter> split(wchar_t delimiter) const & noexcept;
+
+        /**
+         * @brief Gets a lazy range of the parts of this string separated by the given string
+         *
+         * @param delimiter string separating the parts, it is copied into the range,
+         * an empty delimiter does not split this string
+         * @return range of views of the parts, there is one more of them than the non-overlapping delimiters
+         */
+        [[nodiscard]] split::Fields<split::StringDelimiter> split(SimpleStringView delimiter) const &;
+
+        /**
+         * @brief Gets a lazy range of the parts of this string separated by any of the given characters
+         *
+         * @param delimiters characters separating the parts, they are copied into the range
+         * @return range of views of the parts, there is one more of them than the delimiters
+         */
+        [[nodiscard]] split::Fields<split::AnyOfDelimiter> split_any(SimpleStringView delimiters) const &;
+
+        /**
+         * @brief Gets a lazy range of the lines of this string
+         *
+         * @return range of views of the lines without their {@code '\n'} or {@code "\r\n"} terminators,
+         * the terminator of the last line is optional so an empty string has no lines
+         */
+        [[nodiscard]] split::Fields<split::LineDelimiter> lines() const & noexcept;
+
+        /**
+         * @brief Deleted as the ranges would refer to the buffer of a destroyed temporary
+         */
+        split::Fields<split::CharacterDelimiter> split(wchar_t delimiter) const && = delete;
+
+        split::Fields<split::StringDelimiter> split(SimpleStringView delimiter) const && = delete;
+
+        split::Fields<split::AnyOfDelimiter> split_any(SimpleStringView delimiters) const && = delete;
+
+        split::Fields<split::LineDelimiter> lines() const && = delete;
+
         /**
          * @brief Gets the character at the given index.
          *
@@ -224,15 +662,62 @@ namespace lab {
          */
         [[nodiscard]] int compare(const SimpleString &other) const noexcept;
 
+        /**
+         * @brief Hashes this string's characters.
+         *
+         * @return hash of this string, it is the same for all equal strings and views
+         * @note this is remembered until the string is modified if {@link #cache_hash} is enabled,
+         * unless a mutable reference to a character has been obtained since the last modification
+         */
+        [[nodiscard]] size_t hash() const noexcept;
+
+        /**
+         * @brief Encodes this string's characters in UTF-8
+         *
+         * @param out string whose content gets replaced with the encoded bytes, its capacity is reused
+         * @note characters which are not code points (e.g. lone surrogates) are encoded as U+FFFD
+         */
+        void to_utf8(std::string &out) const;
+
+        /**
+         * @brief Encodes this string's characters in UTF-8
+         *
+         * @return the encoded bytes
+         * @note characters which are not code points (e.g. lone surrogates) are encoded as U+FFFD
+         */
+        [[nodiscard]] std::string to_utf8() const;
+
         /*
          * Modifying public methods
          */
 
         /**
          * @brief Shrinks this string so that its buffer has no extra space.
+         *
+         * @note strings fitting into {@code inline_capacity} are moved back into the inline buffer
          */
         void shrink();
 
+        /**
+         * @brief Ensures that this string can hold the given number of characters without reallocating its buffer
+         *
+         * @param capacity minimal capacity of this string
+         * @note the buffer is reallocated to exactly the given capacity if it is not enough
+         */
+        void reserve(size_t capacity);
+
+        /**
+         * @brief Removes all characters from this string keeping its buffer so that its capacity is reused
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Sets the way in which this string's buffer grows
+         *
+         * @param growth_policy new growth policy of this string
+         */
+        void set_growth_policy(GrowthPolicy growth_policy) noexcept;
+
         /**
          * @brief Appends a wide character to this string
          *
@@ -254,6 +739,13 @@ namespace lab {
          */
         void append(const SimpleString &other);
 
+        /**
+         * @brief Appends a string view to this string
+         *
+         * @param other string view which should be appended to this string, it may refer to this string
+         */
+        void append(SimpleStringView other);
+
         /**
          * @brief Sets the character at the given index.
          *
@@ -266,25 +758,37 @@ namespace lab {
          * Special operators
          */
 
+        /**
+         * @note this string keeps its memory resource and growth policy
+         * @note the current buffer is reused if it is big enough
+         */
         SimpleString &operator=(const SimpleString &original);
 
-        SimpleString &operator=(SimpleString &&original) noexcept;
+        /**
+         * @note this string keeps its memory resource and growth policy,
+         * so the original's heap buffer is copied rather than stolen if the resources are not equal
+         * @note the current buffer is reused if the original is stored inline and fits into it
+         */
+        SimpleString &operator=(SimpleString &&original);
 
         /*
-         * Indexed access operators
+         * Conversion operators
          */
 
-        wchar_t operator[](size_t index) const noexcept(false);
-
-        wchar_t &operator[](size_t index) noexcept(false);
+        /**
+         * @brief Creates a view of this string's characters
+         *
+         * @return view of the whole string which is valid until this string is modified or destroyed
+         */
+        operator SimpleStringView() const noexcept; // NOLINT(google-explicit-constructor): views are cheap
 
         /*
-         * Modification operators
+         * Indexed access operators
          */
 
-        SimpleString operator+(const SimpleString &other) const;
+        wchar_t operator[](size_t index) const noexcept(false);
 
-        SimpleString operator*(size_t count) const;
+        wchar_t &operator[](size_t index) noexcept(false);
 
         /*
          * Comparison operators
@@ -303,13 +807,19 @@ namespace lab {
         [[nodiscard]] bool operator<=(const SimpleString &other) const noexcept;
 
 #ifdef __cpp_lib_three_way_comparison
-        [[nodiscard]] bool operator<=>(const SimpleString &other) const noexcept;
+        [[nodiscard]] std::strong_ordering operator<=>(const SimpleString &other) const noexcept;
 #endif
 
         /*
          * Non-instance operator overloads
          */
 
+        friend class CompactString;
+
+        friend class Searcher;
+
+        friend class Rope;
+
         friend std::ostream &operator<<(std::ostream &out, const SimpleString &string);
 
         friend std::wostream &operator<<(std::wostream &out, const SimpleString &string);
@@ -317,12 +827,329 @@ namespace lab {
         friend std::istream &operator>>(std::istream &in, SimpleString &string);
 
         friend std::wistream &operator>>(std::wistream &in, SimpleString &string);
+
+        friend std::istream &read_line(std::istream &in, SimpleString &line, char delimiter);
+
+        friend std::wistream &read_line(std::wistream &in, SimpleString &line, wchar_t delimiter);
+    };
+
+    /*
+     * Input functions
+     */
+
+    /**
+     * @brief Appends the characters of the stream to the string until a line terminator ({@code '\n'} or {@code '\r'})
+     *
+     * @param in stream to read from, the terminator is left in it
+     * @param string string to append to
+     * @return the stream, {@code failbit} is set and the string is left unchanged if the bytes are not valid UTF-8
+     * @note the characters are scanned and appended in chunks of the stream buffer's get area,
+     * the bytes are decoded from UTF-8 even if a sequence is split between two chunks
+     */
+    std::istream &operator>>(std::istream &in, SimpleString &string);
+
+    /**
+     * @brief Appends the characters of the stream to the string until a line terminator ({@code '\n'} or {@code '\r'})
+     *
+     * @param in stream to read from, the terminator is left in it
+     * @param string string to append to
+     * @return the stream
+     * @note the characters are scanned and appended in chunks of the stream buffer's get area
+     */
+    std::wistream &operator>>(std::wistream &in, SimpleString &string);
+
+    /**
+     * @brief Reads a line from the stream replacing the content of the given string, similarly to {@code std::getline}
+     *
+     * @param in stream to read from
+     * @param line string to store the line in, its buffer is reused so reading many lines into it rarely allocates
+     * @param delimiter character terminating the line, it is extracted from the stream but not stored
+     * @return the stream, {@code failbit} is set if no characters were extracted or they are not valid UTF-8
+     * @note the bytes are decoded from UTF-8
+     */
+    std::istream &read_line(std::istream &in, SimpleString &line, char delimiter = '\n');
+
+    /**
+     * @brief Reads a line from the stream replacing the content of the given string, similarly to {@code std::getline}
+     *
+     * @param in stream to read from
+     * @param line string to store the line in, its buffer is reused so reading many lines into it rarely allocates
+     * @param delimiter character terminating the line, it is extracted from the stream but not stored
+     * @return the stream, {@code failbit} is set if no characters were extracted
+     */
+    std::wistream &read_line(std::wistream &in, SimpleString &line, wchar_t delimiter = L'\n');
+
+    /*
+     * Lazy string expressions
+     */
+
+    namespace expression {
+
+        /**
+         * @brief Type used to store the operand of the expression
+         *
+         * @note strings are stored by reference while expressions (which are small) are stored by value
+         */
+        template<typename T>
+        using operand_storage_t = std::conditional_t<std::is_same_v<T, SimpleString>, const SimpleString &, T>;
+
+        inline size_t length_of(const SimpleString &string) noexcept {
+            return string.length();
+        }
+
+        template<StringExpression TExpression>
+        size_t length_of(const TExpression &expression) noexcept {
+            return expression.length();
+        }
+
+        inline wchar_t *write(const SimpleString &string, wchar_t *const destination) {
+            const auto data = string.data();
+            return std::copy(data, data + string.length(), destination);
+        }
+
+        inline size_t length_of(const SimpleStringView view) noexcept {
+            return view.length();
+        }
+
+        inline wchar_t *write(const SimpleStringView view, wchar_t *const destination) {
+            const auto data = view.data();
+            return std::copy(data, data + view.length(), destination);
+        }
+
+        template<StringExpression TExpression>
+        wchar_t *write(const TExpression &expression, wchar_t *const destination) {
+            return expression.write_to(destination);
+        }
+
+        /**
+         * @brief Gets the kind of instrumentation event recorded when the expression is materialized
+         */
+        template<typename T>
+        inline constexpr instrumentation::Event materialization_event = instrumentation::Event::CONCATENATION;
+
+        template<typename TOperand>
+        inline constexpr instrumentation::Event materialization_event<Repetition<TOperand>>
+                = instrumentation::Event::REPETITION;
+
+        /**
+         * @brief Length of the repetitions from which they are filled in parallel
+         */
+        constexpr size_t parallel_fill_threshold = size_t(1) << 22u;
+
+        /**
+         * @brief Repeats the first characters of the buffer until it is filled
+         *
+         * @param destination buffer whose first {@code period} characters are already written
+         * @param period number of the repeated characters
+         * @param length number of characters which the buffer should be filled with,
+         * it should be a multiple of {@code period}
+         * @param pool pool used to fill the buffers of at least {@link #parallel_fill_threshold} characters,
+         * if it fails to run the copies they are done by the calling thread
+         * @note the filled prefix is doubled so that the number of copies is logarithmic rather than linear
+         */
+        void fill_periodic(wchar_t *destination, size_t period, size_t length, ThreadPool &pool);
+
+        /**
+         * @brief Repeats the first characters of the buffer until it is filled using {@link ThreadPool::global()}
+         */
+        void fill_periodic(wchar_t *destination, size_t period, size_t length);
+    }
+
+    /**
+     * @brief Lazy concatenation of two strings or expressions
+     *
+     * @note this refers to the strings it is built from so it should not outlive them,
+     * thus it should be converted to {@link SimpleString} rather than stored in an {@code auto} variable
+     */
+    template<typename TLeft, typename TRight>
+    class Concatenation {
+    protected:
+
+        /**
+         * @brief Left operand
+         */
+        expression::operand_storage_t<TLeft> left_;
+
+        /**
+         * @brief Right operand
+         */
+        expression::operand_storage_t<TRight> right_;
+
+        /**
+         * @brief Length of the result
+         */
+        size_t length_;
+
+    public:
+
+        /**
+         * @brief Creates a new concatenation of the given operands
+         *
+         * @param left left operand
+         * @param right right operand
+         * @throws {@code std::overflow_error} if the result is too big
+         */
+        Concatenation(const TLeft &left, const TRight &right) : left_(left), right_(right) {
+            const auto left_length = expression::length_of(left_), right_length = expression::length_of(right_);
+            if (right_length > SIZE_MAX - left_length) throw std::overflow_error("The resulting string is too big");
+
+            length_ = left_length + right_length;
+        }
+
+        /**
+         * @brief Gets the length of the result
+         *
+         * @return length of the result
+         */
+        [[nodiscard]] size_t length() const noexcept {
+            return length_;
+        }
+
+        /**
+         * @brief Writes the result to the given buffer
+         *
+         * @param destination buffer of at least {@link #length()} characters
+         * @return pointer past the last written character
+         */
+        wchar_t *write_to(wchar_t *const destination) const {
+            return expression::write(right_, expression::write(left_, destination));
+        }
+    };
+
+    /**
+     * @brief Lazy repetition of a string or an expression
+     *
+     * @note this refers to the strings it is built from so it should not outlive them,
+     * thus it should be converted to {@link SimpleString} rather than stored in an {@code auto} variable
+     */
+    template<typename TOperand>
+    class Repetition {
+    protected:
+
+        /**
+         * @brief Repeated operand
+         */
+        expression::operand_storage_t<TOperand> operand_;
+
+        /**
+         * @brief Number of repetitions
+         */
+        size_t count_;
+
+        /**
+         * @brief Length of the result
+         */
+        size_t length_;
+
+    public:
+
+        /**
+         * @brief Creates a new repetition of the given operand
+         *
+         * @param operand repeated operand
+         * @param count number of repetitions
+         * @throws {@code std::overflow_error} if the result is too big
+         */
+        Repetition(const TOperand &operand, const size_t count) : operand_(operand), count_(count) {
+            const auto operand_length = expression::length_of(operand_);
+            if (operand_length != 0 && count > SIZE_MAX / operand_length)
+                throw std::overflow_error("The resulting string is too big");
+
+            length_ = operand_length * count;
+        }
+
+        /**
+         * @brief Gets the length of the result
+         *
+         * @return length of the result
+         */
+        [[nodiscard]] size_t length() const noexcept {
+            return length_;
+        }
+
+        /**
+         * @brief Writes the result to the given buffer
+         *
+         * @param destination buffer of at least {@link #length()} characters
+         * @return pointer past the last written character
+         * @note the operand is evaluated only once and its result is then copied,
+         * results of at least {@link expression::parallel_fill_threshold} characters are copied in parallel
+         * by {@link ThreadPool::global()}
+         */
+        wchar_t *write_to(wchar_t *const destination) const {
+            if (length_ == 0) return destination;
+
+            const auto end = expression::write(operand_, destination);
+            expression::fill_periodic(destination, size_t(end - destination), length_);
+
+            return destination + length_;
+        }
     };
 
+    template<StringExpression TExpression>
+    SimpleString::SimpleString(const TExpression &expression, std::pmr::memory_resource *const resource)
+            : SimpleString(expression.length(), resource) {
+        expression.write_to(buffer_);
+        instrumentation::record(expression::materialization_event<TExpression>, length_ * sizeof(wchar_t));
+    }
+
+    /*
+     * Modification operators
+     */
+
+    /**
+     * @brief Concatenates two strings or expressions lazily
+     *
+     * @param left left operand
+     * @param right right operand
+     * @return expression which is materialized with a single allocation when converted to {@link SimpleString}
+     */
+    template<StringOperand TLeft, StringOperand TRight>
+    Concatenation<TLeft, TRight> operator+(const TLeft &left, const TRight &right) {
+        return Concatenation<TLeft, TRight>(left, right);
+    }
+
+    /**
+     * @brief Repeats a string or an expression lazily
+     *
+     * @param operand repeated operand
+     * @param count number of repetitions
+     * @return expression which is materialized with a single allocation when converted to {@link SimpleString}
+     */
+    template<StringOperand TOperand>
+    Repetition<TOperand> operator*(const TOperand &operand, const size_t count) {
+        return Repetition<TOperand>(operand, count);
+    }
+
+    /*
+     * Expression output
+     */
+
+    template<StringExpression TExpression>
+    std::ostream &operator<<(std::ostream &out, const TExpression &expression) {
+        return out << SimpleString(expression);
+    }
+
+    template<StringExpression TExpression>
+    std::wostream &operator<<(std::wostream &out, const TExpression &expression) {
+        return out << SimpleString(expression);
+    }
+
     /*
      * Define `CustomString` as String
      */
     typedef SimpleString String;
 }
 
+namespace std {
+
+    template<>
+    struct hash<lab::SimpleString> {
+
+        size_t operator()(const lab::SimpleString &string) const noexcept {
+            return string.hash();
+        }
+    };
+}
+
 #endif //SEM_2_LAB_1_SIMPLE_STRING_H
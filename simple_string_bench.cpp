@@ -0,0 +1,410 @@
+#include "simple_string.h"
+#include "simd_kernels.h"
+#include "string_hash.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Microbenchmarks of the public operations of SimpleString
+ *
+ * usage:
+ *   simple_string_bench [--filter <substring>] [--min-time <seconds>] [--output <file>]
+ *     runs the benchmarks whose names contain the substring writing the results as JSON
+ *   simple_string_bench --compare <baseline file> <current file> [--threshold <ratio>]
+ *     compares two result files exiting with status 1 if any benchmark got slower by more than the ratio
+ *
+ * the results are only meaningful for optimized builds (e.g. -DCMAKE_BUILD_TYPE=Release)
+ */
+
+using lab::String;
+
+namespace {
+
+    /*
+     * Measurement
+     */
+
+    /**
+     * @brief Prevents the compiler from optimizing away the computation of the value
+     */
+    template<typename T>
+    inline void keep(const T &value) {
+#if defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+
+    /**
+     * @brief Memory resource counting the allocations, it is made the default one while the benchmarks run
+     */
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        size_t allocations = 0;
+
+    protected:
+        void *do_allocate(const size_t bytes, const size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *const pointer, const size_t bytes, const size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    struct Result {
+        std::string name;
+        size_t iterations;
+        double ns_per_op, bytes_per_second, allocations_per_op;
+    };
+
+    struct Options {
+        std::string filter;
+        double min_time = 0.05;
+        std::string output;
+    };
+
+    class Runner {
+        const Options &options_;
+        CountingResource &resource_;
+        std::vector<Result> results_;
+
+    public:
+        Runner(const Options &options, CountingResource &resource) : options_(options), resource_(resource) {}
+
+        /**
+         * @brief Measures the benchmark doubling the number of iterations until it runs long enough
+         *
+         * @param name name of the benchmark
+         * @param bytes_per_op number of bytes processed by a single operation
+         * @param body runs the given number of operations
+         */
+        void run(const std::string &name, const size_t bytes_per_op, const std::function<void(size_t)> &body) {
+            if (name.find(options_.filter) == std::string::npos) return;
+
+            body(1); // warm-up
+            for (size_t iterations = 1;; iterations *= 2) {
+                resource_.allocations = 0;
+                const auto start = std::chrono::steady_clock::now();
+                body(iterations);
+                const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                if (seconds >= options_.min_time || iterations >= (size_t(1) << 40u)) {
+                    results_.push_back(Result{
+                            name, iterations, seconds * 1e9 / double(iterations),
+                            double(bytes_per_op) * double(iterations) / seconds,
+                            double(resource_.allocations) / double(iterations)
+                    });
+                    std::cerr << name << ": " << results_.back().ns_per_op << " ns/op" << std::endl;
+                    return;
+                }
+            }
+        }
+
+        [[nodiscard]] const std::vector<Result> &results() const noexcept {
+            return results_;
+        }
+    };
+
+    /*
+     * Input data
+     */
+
+    enum class Distribution {
+        /**
+         * @brief Random lowercase Latin letters
+         */
+        ASCII,
+        /**
+         * @brief Random Cyrillic, CJK and emoji characters
+         */
+        UNICODE,
+        /**
+         * @brief Two letters of which one is rare, this produces many partial matches when searching
+         */
+        REPETITIVE
+    };
+
+    constexpr Distribution distributions[]{Distribution::ASCII, Distribution::UNICODE, Distribution::REPETITIVE};
+
+    constexpr size_t sizes[]{8, 64, 1024, 65536};
+
+    const char *name_of(const Distribution distribution) {
+        switch (distribution) {
+            case Distribution::ASCII: return "ascii";
+            case Distribution::UNICODE: return "unicode";
+            case Distribution::REPETITIVE: break;
+        }
+
+        return "repetitive";
+    }
+
+    String generate(const Distribution distribution, const size_t length, std::uint32_t seed) {
+        String string;
+        string.reserve(length);
+        for (size_t i = 0; i < length; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const auto random = seed >> 8u;
+            switch (distribution) {
+                case Distribution::ASCII:
+                    string.append(wchar_t(L'a' + random % 26));
+                    break;
+                case Distribution::UNICODE: {
+                    constexpr wchar_t bases[]{0x410, 0x4E00, 0x1F600};
+                    constexpr std::uint32_t ranges[]{64, 20000, 80};
+                    const auto kind = random % 3;
+                    string.append(wchar_t(bases[kind] + (random >> 2u) % ranges[kind]));
+                    break;
+                }
+                case Distribution::REPETITIVE:
+                    string.append(random % 16 == 0 ? L'b' : L'a');
+                    break;
+            }
+        }
+
+        return string;
+    }
+
+    /*
+     * Benchmarks
+     */
+
+    void run_benchmarks(Runner &runner) {
+        for (const auto distribution: distributions) {
+            for (const auto size: sizes) {
+                const auto suffix = '/' + std::to_string(size) + '/' + name_of(distribution);
+                const auto bytes = size * sizeof(wchar_t);
+
+                const auto source = generate(distribution, size, 42);
+                const String other(source);
+                const std::wstring wide(source.data(), source.length());
+                const auto encoded = source.to_utf8();
+
+                runner.run("construct/wide" + suffix, bytes, [&](const size_t iterations) {
+                    for (size_t i = 0; i < iterations; ++i) keep(String(wide.c_str()));
+                });
+                runner.run("construct/utf8" + suffix, encoded.size(), [&](const size_t iterations) {
+                    for (size_t i = 0; i < iterations; ++i)
+                        keep(String::from_utf8(encoded.data(), encoded.size()));
+                });
+                runner.run("copy" + suffix, bytes, [&](const size_t iterations) {
+                    for (size_t i = 0; i < iterations; ++i) keep(String(source));
+                });
+                runner.run("move" + suffix, bytes, [&](const size_t iterations) {
+                    String first(source), second;
+                    for (size_t i = 0; i < iterations; ++i) {
+                        second = std::move(first);
+                        first = std::move(second);
+                        keep(first);
+                    }
+                });
+                runner.run("assign" + suffix, bytes, [&](const size_t iterations) {
+                    String target;
+                    for (size_t i = 0; i < iterations; ++i) {
+                        target = i % 2 == 0 ? source : other;
+                        keep(target);
+                    }
+                });
+                runner.run("append/growth" + suffix, bytes, [&](const size_t iterations) {
+                    const auto data = source.data();
+                    for (size_t i = 0; i < iterations; ++i) {
+                        String string;
+                        for (size_t j = 0; j < size; ++j) string.append(data[j]);
+                        keep(string);
+                    }
+                });
+                runner.run("concatenate" + suffix, 3 * bytes, [&](const size_t iterations) {
+                    for (size_t i = 0; i < iterations; ++i) keep(String(source + other + source));
+                });
+                runner.run("repeat" + suffix, 8 * bytes, [&](const size_t iterations) {
+                    for (size_t i = 0; i < iterations; ++i) keep(String(source * 8));
+                });
+                runner.run("index_of/character" + suffix, bytes, [&](const size_t iterations) {
+                    // the character is absent so the whole string is scanned
+                    for (size_t i = 0; i < iterations; ++i) keep(source.index_of(L'\u0001'));
+                });
+                runner.run("index_of/substring" + suffix, bytes, [&](const size_t iterations) {
+                    const auto needle_length = std::min<size_t>(size / 4 + 1, 16);
+                    const String needle(lab::SimpleStringView(source).substr(size - needle_length));
+                    for (size_t i = 0; i < iterations; ++i) keep(source.index_of(needle));
+                });
+                runner.run("compare" + suffix, bytes, [&](const size_t iterations) {
+                    for (size_t i = 0; i < iterations; ++i) keep(source.compare(other));
+                });
+                runner.run("hash" + suffix, bytes, [&](const size_t iterations) {
+                    // the hash function itself as the string may remember its hash
+                    for (size_t i = 0; i < iterations; ++i)
+                        keep(lab::hashing::hash_of(source.data(), source.length()));
+                });
+                runner.run("stream/output" + suffix, bytes, [&](const size_t iterations) {
+                    std::ostringstream out;
+                    for (size_t i = 0; i < iterations; ++i) {
+                        out.seekp(0);
+                        out << source;
+                    }
+                    keep(out);
+                });
+                runner.run("stream/read_line" + suffix, encoded.size(), [&](const size_t iterations) {
+                    std::istringstream in(encoded + '\n');
+                    String line;
+                    for (size_t i = 0; i < iterations; ++i) {
+                        in.clear();
+                        in.seekg(0);
+                        read_line(in, line);
+                        keep(line);
+                    }
+                });
+            }
+        }
+    }
+
+    /*
+     * JSON
+     */
+
+    void write_json(std::ostream &out, const std::vector<Result> &results) {
+        out.precision(6);
+        out << "{\n  \"instruction_set\": \"" << lab::simd::name_of(lab::simd::instruction_set()) << "\",\n"
+            << "  \"copy_on_write\": " << (String::copy_on_write ? "true" : "false") << ",\n"
+            << "  \"results\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto &result = results[i];
+            out << (i == 0 ? "\n" : ",\n")
+                << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+                << ", \"ns_per_op\": " << result.ns_per_op << ", \"bytes_per_second\": " << result.bytes_per_second
+                << ", \"allocations_per_op\": " << result.allocations_per_op << '}';
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    /**
+     * @brief Reads the time per operation of each benchmark from the results written by {@link #write_json}
+     *
+     * @throws {@code std::runtime_error} if the file cannot be read
+     */
+    std::map<std::string, double> read_json(const std::string &path) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("Cannot read " + path);
+        std::stringstream content;
+        content << in.rdbuf();
+        const auto json = content.str();
+
+        std::map<std::string, double> times;
+        const std::string name_key("\"name\": \""), time_key("\"ns_per_op\": ");
+        for (auto position = json.find(name_key); position != std::string::npos;
+             position = json.find(name_key, position)) {
+            position += name_key.size();
+            const auto name_end = json.find('"', position);
+            const auto time = json.find(time_key, name_end);
+            if (name_end == std::string::npos || time == std::string::npos)
+                throw std::runtime_error("Malformed results in " + path);
+
+            times[json.substr(position, name_end - position)] = std::strtod(json.c_str() + time + time_key.size(),
+                                                                            nullptr);
+            position = name_end;
+        }
+
+        return times;
+    }
+
+    /**
+     * @brief Prints the change of each benchmark's time
+     *
+     * @return {@code true} if any benchmark got slower by more than the threshold
+     */
+    bool compare(const std::string &baseline_path, const std::string &current_path, const double threshold) {
+        const auto baseline = read_json(baseline_path), current = read_json(current_path);
+
+        auto regressed = false;
+        for (const auto &[name, time]: current) {
+            const auto previous = baseline.find(name);
+            if (previous == baseline.end()) {
+                std::cout << name << ": new (" << time << " ns/op)\n";
+                continue;
+            }
+
+            const auto change = time / previous->second - 1;
+            const auto regression = change > threshold;
+            regressed |= regression;
+            std::cout << name << ": " << previous->second << " -> " << time << " ns/op ("
+                      << (change >= 0 ? "+" : "") << change * 100 << "%)" << (regression ? " REGRESSION" : "") << '\n';
+        }
+        for (const auto &[name, time]: baseline)
+            if (current.find(name) == current.end()) std::cout << name << ": missing\n";
+
+        return regressed;
+    }
+
+    [[noreturn]] void usage() {
+        std::cerr << "usage: simple_string_bench [--filter <substring>] [--min-time <seconds>] [--output <file>]\n"
+                  << "       simple_string_bench --compare <baseline> <current> [--threshold <ratio>]\n";
+        std::exit(2);
+    }
+}
+
+int main(const int argc, char **argv) {
+    Options options;
+    std::string baseline, current;
+    auto threshold = 0.1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument(argv[i]);
+        const auto value = [&]() -> std::string {
+            if (i + 1 >= argc) usage();
+            return argv[++i];
+        };
+
+        if (argument == "--filter") options.filter = value();
+        else if (argument == "--min-time") options.min_time = std::strtod(value().c_str(), nullptr);
+        else if (argument == "--output") options.output = value();
+        else if (argument == "--threshold") threshold = std::strtod(value().c_str(), nullptr);
+        else if (argument == "--compare") {
+            baseline = value();
+            current = value();
+        } else usage();
+    }
+
+    if (!baseline.empty()) {
+        try {
+            return compare(baseline, current, threshold) ? 1 : 0;
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return 2;
+        }
+    }
+
+    CountingResource resource;
+    const auto previous_resource = std::pmr::set_default_resource(&resource);
+    Runner runner(options, resource);
+    run_benchmarks(runner);
+    std::pmr::set_default_resource(previous_resource);
+
+    if (options.output.empty()) write_json(std::cout, runner.results());
+    else {
+        std::ofstream out(options.output);
+        write_json(out, runner.results());
+        if (!out) {
+            std::cerr << "Cannot write " << options.output << std::endl;
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,317 @@
+#include "simple_string_view.h"
+#include "simd_kernels.h"
+#include "string_search.h"
+#include "string_hash.h"
+#include "string_output.h"
+
+#include <cwchar>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+
+namespace lab {
+
+    /*
+     * Internal methods
+     */
+
+    void SimpleStringView::check_index(const size_t index) const noexcept(false) {
+        if (index >= length_) throw std::out_of_range("Index " + std::to_string(index) + " exceeds view length");
+    }
+
+    /*
+     * Public constructors
+     */
+
+    SimpleStringView::SimpleStringView() noexcept: data_(nullptr), length_(0) {}
+
+    SimpleStringView::SimpleStringView(const wchar_t *const data, const size_t length) noexcept
+            : data_(data), length_(length) {}
+
+    SimpleStringView::SimpleStringView(wchar_t const *const wide_c_string) noexcept
+            : data_(wide_c_string), length_(wcslen(wide_c_string)) {}
+
+    /*
+     * Constant public methods
+     */
+
+    size_t SimpleStringView::length() const noexcept {
+        return length_;
+    }
+
+    bool SimpleStringView::empty() const noexcept {
+        return length_ == 0;
+    }
+
+    const wchar_t *SimpleStringView::data() const noexcept {
+        return data_;
+    }
+
+    wchar_t SimpleStringView::at(const size_t index) const noexcept(false) {
+        check_index(index);
+
+        return data_[index];
+    }
+
+    SimpleStringView SimpleStringView::substr(const size_t start, const size_t length) const noexcept(false) {
+        if (start > length_) throw std::out_of_range("Index " + std::to_string(start) + " exceeds view length");
+
+        return SimpleStringView(data_ + start, std::min(length, length_ - start));
+    }
+
+    std::optional<size_t> SimpleStringView::index_of(const wchar_t character) const noexcept {
+        const auto length = length_;
+        const auto index = length < search::parallel_threshold()
+                ? simd::find_character(data_, length, character)
+                : search::find_character_parallel(data_, length, character);
+
+        return index == length ? std::optional<size_t>() : std::optional<size_t>(index);
+    }
+
+    std::optional<size_t> SimpleStringView::index_of(const char character) const noexcept {
+        return index_of(wchar_t(character));
+    }
+
+    std::optional<size_t> SimpleStringView::index_of(const SimpleStringView other) const noexcept {
+        if (other.empty()) return 0;
+
+        const auto length = length_, other_length = other.length_;
+        if (other_length > length) return std::optional<size_t>();
+
+        search::Pattern pattern;
+        search::compile(pattern, other.data_, other_length);
+        const auto index = length < search::parallel_threshold()
+                ? search::find(pattern, other.data_, other_length, data_, length)
+                : search::find_parallel(pattern, other.data_, other_length, data_, length);
+
+        return index == length ? std::optional<size_t>() : std::optional<size_t>(index);
+    }
+
+    std::optional<size_t> SimpleStringView::index_of(const wchar_t character, const size_t from) const noexcept {
+        if (from >= length_) return std::optional<size_t>();
+
+        const auto index = SimpleStringView(data_ + from, length_ - from).index_of(character);
+        return index ? std::optional<size_t>(from + *index) : index;
+    }
+
+    std::optional<size_t> SimpleStringView::index_of(const SimpleStringView other, const size_t from) const noexcept {
+        if (from > length_) return std::optional<size_t>();
+
+        const auto index = SimpleStringView(data_ + from, length_ - from).index_of(other);
+        return index ? std::optional<size_t>(from + *index) : index;
+    }
+
+    std::optional<size_t> SimpleStringView::last_index_of(const wchar_t character) const noexcept {
+        const auto length = length_;
+        const auto index = simd::find_last_character(data_, length, character);
+
+        return index == length ? std::optional<size_t>() : std::optional<size_t>(index);
+    }
+
+    std::optional<size_t> SimpleStringView::last_index_of(const SimpleStringView other) const noexcept {
+        const auto length = length_, other_length = other.length_;
+        if (other_length == 0) return length;
+        if (other_length > length) return std::optional<size_t>();
+
+        search::Pattern pattern;
+        search::compile_reversed(pattern, other.data_, other_length);
+        const auto index = search::find_last(pattern, other.data_, other_length, data_, length);
+
+        return index == length ? std::optional<size_t>() : std::optional<size_t>(index);
+    }
+
+    size_t SimpleStringView::count(const wchar_t character) const noexcept {
+        return simd::count_character(data_, length_, character);
+    }
+
+    size_t SimpleStringView::count(const SimpleStringView other) const noexcept {
+        const auto length = length_, other_length = other.length_;
+        if (other_length == 0) return length + 1;
+        if (other_length == 1) return count(other.data_[0]);
+        if (other_length > length) return 0;
+
+        search::Pattern pattern;
+        search::compile(pattern, other.data_, other_length);
+        size_t count = 0;
+        for (size_t from = 0; other_length <= length - from; ++count) {
+            const auto index = search::find(pattern, other.data_, other_length, data_ + from, length - from);
+            if (index == length - from) break;
+
+            from += index + 1;
+        }
+
+        return count;
+    }
+
+    search::Occurrences SimpleStringView::find_all(const SimpleStringView other) const {
+        return search::Occurrences(data_, length_, other.data_, other.length_);
+    }
+
+    split::Fields<split::CharacterDelimiter> SimpleStringView::split(const wchar_t delimiter) const noexcept {
+        return split::Fields<split::CharacterDelimiter>(*this, split::CharacterDelimiter{delimiter});
+    }
+
+    split::Fields<split::StringDelimiter> SimpleStringView::split(const SimpleStringView delimiter) const {
+        return split::Fields<split::StringDelimiter>(
+                *this, split::StringDelimiter(delimiter.data_, delimiter.length_)
+        );
+    }
+
+    split::Fields<split::AnyOfDelimiter>
+    SimpleStringView::split_any(const SimpleStringView delimiters) const {
+        return split::Fields<split::AnyOfDelimiter>(*this, split::AnyOfDelimiter(delimiters));
+    }
+
+    split::Fields<split::LineDelimiter> SimpleStringView::lines() const noexcept {
+        return split::Fields<split::LineDelimiter>(*this, split::LineDelimiter());
+    }
+
+    bool SimpleStringView::starts_with(const SimpleStringView prefix) const noexcept {
+        const auto prefix_length = prefix.length_;
+        return prefix_length <= length_ && simd::mismatch(data_, prefix.data_, prefix_length) == prefix_length;
+    }
+
+    bool SimpleStringView::ends_with(const SimpleStringView suffix) const noexcept {
+        const auto length = length_, suffix_length = suffix.length_;
+        return suffix_length <= length
+               && simd::mismatch(data_ + (length - suffix_length), suffix.data_, suffix_length) == suffix_length;
+    }
+
+    bool SimpleStringView::equals(const SimpleStringView other) const noexcept {
+        const auto length = length_;
+        if (length != other.length_) return false;
+
+        return simd::mismatch(data_, other.data_, length) == length;
+    }
+
+    int SimpleStringView::compare(const SimpleStringView other) const noexcept {
+        const auto length = length_, other_length = other.length_;
+
+        if (length == other_length) {
+            const auto index = simd::mismatch(data_, other.data_, length);
+            if (index == length) return 0;
+
+            return data_[index] > other.data_[index] ? 1 : -1;
+        }
+
+        return length > other_length ? 1 : -1;
+    }
+
+    size_t SimpleStringView::hash() const noexcept {
+        return hashing::hash_of(data_, length_);
+    }
+
+    /*
+     * Indexed access operators
+     */
+
+    wchar_t SimpleStringView::operator[](const size_t index) const noexcept(false) {
+        return at(index);
+    }
+
+    /*
+     * Comparison operators
+     */
+
+    bool SimpleStringView::operator==(const SimpleStringView other) const noexcept {
+        return equals(other);
+    }
+
+    bool SimpleStringView::operator!=(const SimpleStringView other) const noexcept {
+        return !equals(other);
+    }
+
+    bool SimpleStringView::operator>(const SimpleStringView other) const noexcept {
+        return compare(other) > 0;
+    }
+
+    bool SimpleStringView::operator>=(const SimpleStringView other) const noexcept {
+        return compare(other) >= 0;
+    }
+
+    bool SimpleStringView::operator<(const SimpleStringView other) const noexcept {
+        return compare(other) < 0;
+    }
+
+    bool SimpleStringView::operator<=(const SimpleStringView other) const noexcept {
+        return compare(other) <= 0;
+    }
+
+    std::strong_ordering SimpleStringView::operator<=>(const SimpleStringView other) const noexcept {
+        return compare(other) <=> 0;
+    }
+
+    std::ostream &operator<<(std::ostream &out, const SimpleStringView view) {
+        return output::write_formatted(out, view.length_, [view](std::streambuf &buffer) {
+            return output::write(buffer, view.data_, view.length_);
+        });
+    }
+
+    std::wostream &operator<<(std::wostream &out, const SimpleStringView view) {
+        return output::write_formatted(out, view.length_, [view](std::wstreambuf &buffer) {
+            return output::write(buffer, view.data_, view.length_);
+        });
+    }
+
+    /*
+     * Delimiters
+     */
+
+    namespace split {
+
+        size_t CharacterDelimiter::find(const wchar_t *const data, const size_t length) const noexcept {
+            return simd::find_character(data, length, character);
+        }
+
+        StringDelimiter::StringDelimiter(const wchar_t *const delimiter, const size_t delimiter_length)
+                : delimiter(delimiter, delimiter_length), pattern() {
+            search::compile(pattern, this->delimiter.data(), delimiter_length);
+        }
+
+        size_t StringDelimiter::find(const wchar_t *const data, const size_t length) const noexcept {
+            const auto delimiter_length = delimiter.length();
+            // an empty delimiter would be found at every position
+            if (delimiter_length == 0) return length;
+
+            return search::find(pattern, delimiter.data(), delimiter_length, data, length);
+        }
+
+        /**
+         * @brief Gets the part of the set which should be checked linearly
+         *
+         * @param characters characters of the set
+         * @return the part of the set starting with its first character which is not below 256
+         */
+        static SimpleStringView wide_part(const SimpleStringView characters) noexcept {
+            size_t wide_begin = 0;
+            while (wide_begin < characters.length()
+                   && static_cast<std::make_unsigned_t<wchar_t>>(characters[wide_begin]) < 256) ++wide_begin;
+
+            return characters.substr(wide_begin);
+        }
+
+        AnyOfDelimiter::AnyOfDelimiter(const SimpleStringView characters)
+                : wide_characters(wide_part(characters).data(), wide_part(characters).length()), narrow_characters() {
+            for (size_t i = 0; i < characters.length(); ++i) {
+                const auto code = static_cast<std::make_unsigned_t<wchar_t>>(characters[i]);
+                if (code < 256) narrow_characters[code / 64] |= std::uint64_t(1) << (code % 64);
+            }
+        }
+
+        size_t AnyOfDelimiter::find(const wchar_t *const data, const size_t length) const noexcept {
+            for (size_t i = 0; i < length; ++i) {
+                const auto code = static_cast<std::make_unsigned_t<wchar_t>>(data[i]);
+                if (code < 256) {
+                    if (narrow_characters[code / 64] >> (code % 64) & 1u) return i;
+                } else if (SimpleStringView(wide_characters.data(), wide_characters.length()).index_of(data[i]))
+                    return i;
+            }
+
+            return length;
+        }
+
+        size_t LineDelimiter::find(const wchar_t *const data, const size_t length) const noexcept {
+            return simd::find_character(data, length, L'\n');
+        }
+    }
+}
@@ -0,0 +1,591 @@
+#ifndef SEM_2_LAB_1_SIMPLE_STRING_VIEW_H
+#define SEM_2_LAB_1_SIMPLE_STRING_VIEW_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <optional>
+#include <compare>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "search_pattern.h"
+
+namespace lab {
+
+    namespace split {
+
+        struct CharacterDelimiter;
+
+        struct StringDelimiter;
+
+        struct AnyOfDelimiter;
+
+        struct LineDelimiter;
+
+        template<typename TDelimiter>
+        class Fields;
+    }
+
+    /**
+     * @brief Non-owning reference to a sequence of wide characters (e.g. a part of {@link SimpleString})
+     *
+     * @note the referred characters should outlive the view and should not be reallocated while it is used
+     */
+    class SimpleStringView {
+    protected:
+
+        /**
+         * @brief Referred characters
+         *
+         * @note referred string is not 0-terminated
+         */
+        const wchar_t *data_;
+
+        /**
+         * @brief Number of referred characters
+         */
+        size_t length_;
+
+        /*
+         * Internal methods
+         */
+
+        /**
+         * @brief Checks if the given index is smaller than this view's length otherwise throwin an exception.
+         * @param index index which should be compared with this view's length
+         * @throws {@code std::out_of_range} if the index is greater or equal to this view's length
+         */
+        void check_index(size_t index) const noexcept(false);
+
+    public:
+
+        /*
+         * Public constructors
+         */
+
+        /**
+         * @brief Creates a new empty view
+         */
+        SimpleStringView() noexcept;
+
+        /**
+         * @brief Creates a new view of the given characters
+         *
+         * @param data first of the referred characters
+         * @param length number of the referred characters
+         */
+        SimpleStringView(const wchar_t *data, size_t length) noexcept;
+
+        /**
+         * @brief Creates a new view of the given wide-C-string (0-terminated {@code wchar_t}-array)
+         *
+         * @param wide_c_string referred string, its trailing {@code '\0'} is not included into the view
+         */
+        explicit SimpleStringView(wchar_t const *wide_c_string) noexcept;
+
+        /*
+         * Constant public methods
+         */
+
+        /**
+         * @brief Gets this view's length
+         *
+         * @return length of this view
+         */
+        [[nodiscard]] size_t length() const noexcept;
+
+        /**
+         * @brief Checks if this view is empty
+         *
+         * @return {@code true} if this view is empty and {@code} false otherwise
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Gets the pointer to the referred characters
+         *
+         * @return pointer to the first of {@link #length()} referred characters
+         */
+        [[nodiscard]] const wchar_t *data() const noexcept;
+
+        /**
+         * @brief Gets the character at the given index.
+         *
+         * @param index index at which to get the character
+         * @return character at the given index
+         * @throws {@code std::out_of_range} if the index is greater or equal to this view's length
+         */
+        [[nodiscard]] wchar_t at(size_t index) const noexcept(false);
+
+        /**
+         * @brief Gets a view of a part of this view without copying the characters.
+         *
+         * @param start index of the first character of the part
+         * @param length length of the part, it is limited by the length of this view
+         * @return view of the part
+         * @throws {@code std::out_of_range} if the start is greater than this view's length
+         */
+        [[nodiscard]] SimpleStringView substr(size_t start, size_t length = SIZE_MAX) const noexcept(false);
+
+        /**
+         * @brief Gets an index of the first occurrence of the given wide character
+         *
+         * @param character wide character to find
+         * @return optional of wide character's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> index_of(wchar_t character) const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the given character
+         *
+         * @param character character to find
+         * @return optional of character's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> index_of(char character) const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the given string
+         *
+         * @param other string to find
+         * @return optional of string's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> index_of(SimpleStringView other) const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the given wide character at or after the given index
+         *
+         * @param character wide character to find
+         * @param from index from which to search, it may exceed this view's length
+         * @return optional of wide character's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> index_of(wchar_t character, size_t from) const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the given string at or after the given index
+         *
+         * @param other string to find
+         * @param from index from which to search, it may exceed this view's length
+         * @return optional of string's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> index_of(SimpleStringView other, size_t from) const noexcept;
+
+        /**
+         * @brief Gets an index of the last occurrence of the given wide character
+         *
+         * @param character wide character to find
+         * @return optional of wide character's index if it was found or an empty optional otherwise
+         */
+        [[nodiscard]] std::optional<size_t> last_index_of(wchar_t character) const noexcept;
+
+        /**
+         * @brief Gets an index of the last occurrence of the given string
+         *
+         * @param other string to find
+         * @return optional of string's index if it was found or an empty optional otherwise,
+         * an empty string is found at this view's length
+         */
+        [[nodiscard]] std::optional<size_t> last_index_of(SimpleStringView other) const noexcept;
+
+        /**
+         * @brief Counts the occurrences of the given wide character
+         *
+         * @param character wide character to count
+         * @return number of the character's occurrences
+         */
+        [[nodiscard]] size_t count(wchar_t character) const noexcept;
+
+        /**
+         * @brief Counts the occurrences of the given string including overlapping ones
+         *
+         * @param other string to count
+         * @return number of the string's occurrences, an empty string occurs {@code length() + 1} times
+         */
+        [[nodiscard]] size_t count(SimpleStringView other) const noexcept;
+
+        /**
+         * @brief Gets a lazy range of the positions of all occurrences of the given string including overlapping ones
+         *
+         * @param other string to find, it is copied into the range
+         * @return range of the occurrences' indices in increasing order
+         * @note this does not allocate unless the needle is longer than {@link search::short_needle_length}
+         */
+        [[nodiscard]] search::Occurrences find_all(SimpleStringView other) const;
+
+        /**
+         * @brief Gets a lazy range of the parts of this view separated by the given character
+         *
+         * @param delimiter character separating the parts
+         * @return range of views of the parts, there is one more of them than the delimiters
+         * @note the delimiter is found by the vectorized character search and no part is copied
+         */
+        [[nodiscard]] split::Fields<split::CharacterDelimiter> split(wchar_t delimiter) const noexcept;
+
+        /**
+         * @brief Gets a lazy range of the parts of this view separated by the given string
+         *
+         * @param delimiter string separating the parts, it is copied into the range,
+         * an empty delimiter does not split this view
+         * @return range of views of the parts, there is one more of them than the non-overlapping delimiters
+         */
+        [[nodiscard]] split::Fields<split::StringDelimiter> split(SimpleStringView delimiter) const;
+
+        /**
+         * @brief Gets a lazy range of the parts of this view separated by any of the given characters
+         *
+         * @param delimiters characters separating the parts, they are copied into the range
+         * @return range of views of the parts, there is one more of them than the delimiters
+         */
+        [[nodiscard]] split::Fields<split::AnyOfDelimiter> split_any(SimpleStringView delimiters) const;
+
+        /**
+         * @brief Gets a lazy range of the lines of this view
+         *
+         * @return range of views of the lines without their {@code '\n'} or {@code "\r\n"} terminators,
+         * the terminator of the last line is optional so an empty view has no lines
+         */
+        [[nodiscard]] split::Fields<split::LineDelimiter> lines() const noexcept;
+
+        /**
+         * @brief Checks if this view starts with the given string
+         *
+         * @param prefix expected prefix
+         * @return {@code true} if this view starts with the prefix and {@code false} otherwise
+         */
+        [[nodiscard]] bool starts_with(SimpleStringView prefix) const noexcept;
+
+        /**
+         * @brief Checks if this view ends with the given string
+         *
+         * @param suffix expected suffix
+         * @return {@code true} if this view ends with the suffix and {@code false} otherwise
+         */
+        [[nodiscard]] bool ends_with(SimpleStringView suffix) const noexcept;
+
+        /**
+         * @brief Checks is this view is equal to the given.
+         *
+         * @param other string to compare with
+         * @return {@code true} if the referred characters are equal and {@code false} otherwise
+         */
+        [[nodiscard]] bool equals(SimpleStringView other) const noexcept;
+
+        /**
+         * @brief Compares this view with the given one.
+         *
+         * @param other string to compare this one with
+         * @return the same as {@link SimpleString#compare(const SimpleString &)} would for the referred characters
+         */
+        [[nodiscard]] int compare(SimpleStringView other) const noexcept;
+
+        /**
+         * @brief Hashes the referred characters.
+         *
+         * @return the same as {@link SimpleString#hash()} would for the referred characters
+         */
+        [[nodiscard]] size_t hash() const noexcept;
+
+        /*
+         * Indexed access operators
+         */
+
+        wchar_t operator[](size_t index) const noexcept(false);
+
+        /*
+         * Comparison operators
+         */
+
+        [[nodiscard]] bool operator==(SimpleStringView other) const noexcept;
+
+        [[nodiscard]] bool operator!=(SimpleStringView other) const noexcept;
+
+        [[nodiscard]] bool operator>(SimpleStringView other) const noexcept;
+
+        [[nodiscard]] bool operator>=(SimpleStringView other) const noexcept;
+
+        [[nodiscard]] bool operator<(SimpleStringView other) const noexcept;
+
+        [[nodiscard]] bool operator<=(SimpleStringView other) const noexcept;
+
+        [[nodiscard]] std::strong_ordering operator<=>(SimpleStringView other) const noexcept;
+
+        /*
+         * Non-instance operator overloads
+         */
+
+        friend std::ostream &operator<<(std::ostream &out, SimpleStringView view);
+
+        friend std::wostream &operator<<(std::wostream &out, SimpleStringView view);
+    };
+
+    namespace split {
+
+        /**
+         * @brief Single-character delimiter
+         */
+        struct CharacterDelimiter {
+
+            /**
+             * @brief Whether the delimiter terminates the parts rather than separates them
+             * (so that no empty part follows the last delimiter)
+             */
+            static constexpr bool terminator = false;
+
+            wchar_t character;
+
+            /**
+             * @brief Finds the first delimiter in the characters
+             *
+             * @param data characters to search in
+             * @param length number of characters
+             * @return index of the delimiter or {@code length} if there is none
+             */
+            [[nodiscard]] size_t find(const wchar_t *data, size_t length) const noexcept;
+
+            /**
+             * @brief Gets the number of characters of a found delimiter
+             *
+             * @return length of the delimiter
+             */
+            [[nodiscard]] size_t length() const noexcept {
+                return 1;
+            }
+
+            /**
+             * @brief Gets the part preceding a delimiter
+             *
+             * @param data first character of the part
+             * @param length number of characters up to the delimiter
+             * @return view of the part
+             */
+            [[nodiscard]] SimpleStringView part(const wchar_t *const data, const size_t length) const noexcept {
+                return SimpleStringView(data, length);
+            }
+        };
+
+        /**
+         * @brief Multi-character delimiter found by the search engine
+         */
+        struct StringDelimiter {
+
+            static constexpr bool terminator = false;
+
+            /**
+             * @brief Copy of the delimiter
+             */
+            search::NeedleBuffer delimiter;
+
+            /**
+             * @brief Data precomputed for the delimiter
+             */
+            search::Pattern pattern;
+
+            /**
+             * @brief Creates a new delimiter copying its characters and compiling its pattern
+             *
+             * @param delimiter characters of the delimiter
+             * @param delimiter_length number of characters of the delimiter
+             */
+            StringDelimiter(const wchar_t *delimiter, size_t delimiter_length);
+
+            [[nodiscard]] size_t find(const wchar_t *data, size_t length) const noexcept;
+
+            [[nodiscard]] size_t length() const noexcept {
+                return delimiter.length();
+            }
+
+            [[nodiscard]] SimpleStringView part(const wchar_t *const data, const size_t length) const noexcept {
+                return SimpleStringView(data, length);
+            }
+        };
+
+        /**
+         * @brief Delimiter being any character of a set
+         */
+        struct AnyOfDelimiter {
+
+            static constexpr bool terminator = false;
+
+            /**
+             * @brief Copy of the characters of the set which are not below 256
+             */
+            search::NeedleBuffer wide_characters;
+
+            /**
+             * @brief Bit set of the characters of the set which are below 256
+             */
+            std::uint64_t narrow_characters[4];
+
+            /**
+             * @brief Creates a new delimiter of the characters
+             *
+             * @param characters characters of the set
+             */
+            explicit AnyOfDelimiter(SimpleStringView characters);
+
+            [[nodiscard]] size_t find(const wchar_t *data, size_t length) const noexcept;
+
+            [[nodiscard]] size_t length() const noexcept {
+                return 1;
+            }
+
+            [[nodiscard]] SimpleStringView part(const wchar_t *const data, const size_t length) const noexcept {
+                return SimpleStringView(data, length);
+            }
+        };
+
+        /**
+         * @brief Line terminator, either {@code '\n'} or {@code "\r\n"}
+         */
+        struct LineDelimiter {
+
+            static constexpr bool terminator = true;
+
+            [[nodiscard]] size_t find(const wchar_t *data, size_t length) const noexcept;
+
+            [[nodiscard]] size_t length() const noexcept {
+                return 1;
+            }
+
+            [[nodiscard]] SimpleStringView part(const wchar_t *const data, const size_t length) const noexcept {
+                return SimpleStringView(data, length != 0 && data[length - 1] == L'\r' ? length - 1 : length);
+            }
+        };
+
+        /**
+         * @brief Lazy range of the parts of a view separated by delimiters
+         *
+         * @tparam TDelimiter type of the delimiter
+         * @note the range refers to the characters of the view which should outlive it
+         * @note iteration does not allocate, each step finds the next delimiter
+         */
+        template<typename TDelimiter>
+        class Fields {
+        protected:
+
+            /**
+             * @brief Marker of the position past the last part
+             */
+            static constexpr size_t no_position = SIZE_MAX;
+
+            SimpleStringView view_;
+
+            TDelimiter delimiter_;
+
+            /**
+             * @brief Gets the end of the part starting at the given position
+             *
+             * @param begin index of the part's first character
+             * @return index of the delimiter following the part or the view's length if there is none
+             */
+            [[nodiscard]] size_t part_end(const size_t begin) const noexcept {
+                return begin + delimiter_.find(view_.data() + begin, view_.length() - begin);
+            }
+
+        public:
+
+            /**
+             * @brief Forward iterator over the parts
+             */
+            class Iterator {
+            protected:
+
+                /**
+                 * @brief Iterated range, {@code nullptr} for a default-constructed iterator
+                 */
+                const Fields *fields_ = nullptr;
+
+                /**
+                 * @brief Index of the current part's first character or {@code no_position} past the last part
+                 */
+                size_t begin_ = no_position;
+
+                /**
+                 * @brief Index of the delimiter following the current part
+                 */
+                size_t end_ = no_position;
+
+            public:
+
+                using iterator_concept = std::forward_iterator_tag;
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = SimpleStringView;
+                using difference_type = std::ptrdiff_t;
+
+                Iterator() noexcept = default;
+
+                /**
+                 * @brief Creates a new iterator at the part starting at the given position
+                 *
+                 * @param fields iterated range
+                 * @param begin index of the part's first character or {@code no_position}
+                 */
+                Iterator(const Fields &fields, const size_t begin) noexcept
+                        : fields_(&fields), begin_(begin),
+                          end_(begin == no_position ? no_position : fields.part_end(begin)) {}
+
+                [[nodiscard]] SimpleStringView operator*() const noexcept {
+                    return fields_->delimiter_.part(fields_->view_.data() + begin_, end_ - begin_);
+                }
+
+                Iterator &operator++() noexcept {
+                    const auto length = fields_->view_.length();
+                    if (end_ == length) begin_ = end_ = no_position;
+                    else {
+                        begin_ = end_ + fields_->delimiter_.length();
+                        if (TDelimiter::terminator && begin_ == length) begin_ = end_ = no_position;
+                        else end_ = fields_->part_end(begin_);
+                    }
+
+                    return *this;
+                }
+
+                Iterator operator++(int) noexcept {
+                    const auto previous = *this;
+                    ++*this;
+                    return previous;
+                }
+
+                [[nodiscard]] bool operator==(const Iterator &other) const noexcept {
+                    return begin_ == other.begin_;
+                }
+
+                [[nodiscard]] bool operator==(std::default_sentinel_t) const noexcept {
+                    return begin_ == no_position;
+                }
+            };
+
+            /**
+             * @brief Creates a new range of the parts of the view
+             *
+             * @param view view to split
+             * @param delimiter delimiter separating the parts
+             */
+            Fields(const SimpleStringView view, TDelimiter delimiter) noexcept
+                    : view_(view), delimiter_(std::move(delimiter)) {}
+
+            [[nodiscard]] Iterator begin() const noexcept {
+                return Iterator(*this, TDelimiter::terminator && view_.empty() ? no_position : 0);
+            }
+
+            [[nodiscard]] std::default_sentinel_t end() const noexcept {
+                return std::default_sentinel;
+            }
+        };
+    }
+}
+
+namespace std {
+
+    template<>
+    struct hash<lab::SimpleStringView> {
+
+        size_t operator()(const lab::SimpleStringView view) const noexcept {
+            return view.hash();
+        }
+    };
+}
+
+#endif //SEM_2_LAB_1_SIMPLE_STRING_VIEW_H
@@ -0,0 +1,147 @@
+#include "string_column.h"
+#include "simd_kernels.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace lab {
+
+    /*
+     * Internal methods
+     */
+
+    void StringColumn::check_index(const size_t index) const noexcept(false) {
+        if (index >= size()) throw std::out_of_range("Index " + std::to_string(index) + " exceeds column size");
+    }
+
+    /*
+     * Public constructors
+     */
+
+    StringColumn::StringColumn(std::pmr::memory_resource *const resource)
+            : characters_(resource), offsets_(1, 0, resource) {}
+
+    /*
+     * Constant public methods
+     */
+
+    size_t StringColumn::size() const noexcept {
+        return offsets_.size() - 1;
+    }
+
+    bool StringColumn::empty() const noexcept {
+        return offsets_.size() == 1;
+    }
+
+    size_t StringColumn::character_count() const noexcept {
+        return characters_.size();
+    }
+
+    SimpleStringView StringColumn::at(const size_t index) const noexcept(false) {
+        check_index(index);
+
+        return (*this)[index];
+    }
+
+    StringColumn::Iterator StringColumn::begin() const noexcept {
+        return Iterator(*this, 0);
+    }
+
+    StringColumn::Iterator StringColumn::end() const noexcept {
+        return Iterator(*this, size());
+    }
+
+    std::optional<size_t> StringColumn::find(const SimpleStringView value) const noexcept {
+        const auto length = value.length();
+        const auto characters = characters_.data(), value_characters = value.data();
+        for (size_t i = 0, count = size(); i < count; ++i) {
+            const auto begin = offsets_[i];
+            if (offsets_[i + 1] - begin == length
+                && simd::mismatch(characters + begin, value_characters, length) == length)
+                return i;
+        }
+
+        return std::optional<size_t>();
+    }
+
+    std::vector<bool> StringColumn::equals(const SimpleStringView value) const {
+        const auto length = value.length();
+        const auto characters = characters_.data(), value_characters = value.data();
+
+        std::vector<bool> results(size());
+        for (size_t i = 0, count = results.size(); i < count; ++i) {
+            const auto begin = offsets_[i];
+            results[i] = offsets_[i + 1] - begin == length
+                         && simd::mismatch(characters + begin, value_characters, length) == length;
+        }
+
+        return results;
+    }
+
+    std::vector<int> StringColumn::compare(const SimpleStringView value) const {
+        std::vector<int> results(size());
+        for (size_t i = 0, count = results.size(); i < count; ++i) results[i] = (*this)[i].compare(value);
+
+        return results;
+    }
+
+    std::vector<std::optional<size_t>> StringColumn::index_of(const SimpleStringView other) const {
+        const auto other_length = other.length();
+        search::Pattern pattern;
+        search::compile(pattern, other.data(), other_length);
+
+        std::vector<std::optional<size_t>> results(size());
+        for (size_t i = 0, count = results.size(); i < count; ++i) {
+            const auto string = (*this)[i];
+            const auto length = string.length();
+            if (other_length > length) continue;
+
+            const auto index = search::find(pattern, other.data(), other_length, string.data(), length);
+            if (index != length || other_length == 0) results[i] = index;
+        }
+
+        return results;
+    }
+
+    /*
+     * Public methods
+     */
+
+    void StringColumn::reserve(const size_t string_count, const size_t character_count) {
+        offsets_.reserve(string_count + 1);
+        characters_.reserve(character_count);
+    }
+
+    void StringColumn::push_back(const SimpleStringView value) {
+        const auto length = value.length();
+        const auto begin = characters_.size();
+
+        // the value may refer to the characters which are moved by the reallocation
+        const auto data = characters_.data();
+        const std::less<const wchar_t *> less;
+        if (!less(value.data(), data) && less(value.data(), data + begin)) {
+            const auto source = size_t(value.data() - data);
+            characters_.resize(begin + length);
+            std::copy_n(characters_.data() + source, length, characters_.data() + begin);
+        } else characters_.insert(characters_.end(), value.data(), value.data() + length);
+
+        try {
+            offsets_.push_back(begin + length);
+        } catch (...) {
+            // otherwise the characters would become a prefix of the next element
+            characters_.resize(begin);
+            throw;
+        }
+    }
+
+    void StringColumn::push_back(const SimpleString &value) {
+        push_back(SimpleStringView(value));
+    }
+
+    void StringColumn::clear() noexcept {
+        characters_.clear();
+        offsets_.resize(1);
+    }
+}
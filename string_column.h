@@ -0,0 +1,226 @@
+#ifndef SEM_2_LAB_1_STRING_COLUMN_H
+#define SEM_2_LAB_1_STRING_COLUMN_H
+
+
+#include "simple_string.h"
+#include "simple_string_view.h"
+
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+namespace lab {
+
+    /**
+     * @brief Append-only column of strings storing all of their characters in a single buffer
+     *
+     * @note the i-th string consists of the characters between {@code offsets_[i]} and {@code offsets_[i + 1]}
+     * so a string costs a single offset rather than a heap allocation and a {@link SimpleString} header
+     * @note views of the strings are invalidated when the column grows beyond its reserved capacity
+     */
+    class StringColumn {
+    protected:
+
+        /**
+         * @brief Characters of all strings one after another
+         */
+        std::pmr::vector<wchar_t> characters_;
+
+        /**
+         * @brief Offsets of the strings in {@code characters_}, one more than the number of strings
+         */
+        std::pmr::vector<size_t> offsets_;
+
+        /*
+         * Internal methods
+         */
+
+        /**
+         * @brief Checks if the given index is smaller than the number of strings otherwise throwing an exception.
+         *
+         * @param index index which should be compared with the number of strings
+         * @throws {@code std::out_of_range} if the index is greater or equal to the number of strings
+         */
+        void check_index(size_t index) const noexcept(false);
+
+    public:
+
+        /**
+         * @brief Forward iterator over the views of the strings
+         */
+        class Iterator {
+        protected:
+
+            const StringColumn *column_ = nullptr;
+
+            size_t index_ = 0;
+
+        public:
+
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = SimpleStringView;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() noexcept = default;
+
+            /**
+             * @brief Creates a new iterator at the given string of the column
+             *
+             * @param column iterated column
+             * @param index index of the string
+             */
+            Iterator(const StringColumn &column, const size_t index) noexcept : column_(&column), index_(index) {}
+
+            [[nodiscard]] SimpleStringView operator*() const noexcept {
+                return (*column_)[index_];
+            }
+
+            Iterator &operator++() noexcept {
+                ++index_;
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept {
+                const auto previous = *this;
+                ++index_;
+                return previous;
+            }
+
+            [[nodiscard]] bool operator==(const Iterator &other) const noexcept {
+                return index_ == other.index_;
+            }
+        };
+
+        /*
+         * Public constructors
+         */
+
+        /**
+         * @brief Creates a new empty column
+         *
+         * @param resource memory resource used for the characters and the offsets, it should outlive the column
+         */
+        explicit StringColumn(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+        /*
+         * Constant public methods
+         */
+
+        /**
+         * @brief Gets the number of strings in this column
+         *
+         * @return number of strings
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * @brief Checks if this column has no strings
+         *
+         * @return {@code true} if this column is empty and {@code false} otherwise
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Gets the total number of characters of the strings
+         *
+         * @return number of characters stored in this column
+         */
+        [[nodiscard]] size_t character_count() const noexcept;
+
+        /**
+         * @brief Gets a view of the string at the given index
+         *
+         * @param index index of the string
+         * @return view of the string's characters
+         * @throws {@code std::out_of_range} if the index is greater or equal to the number of strings
+         */
+        [[nodiscard]] SimpleStringView at(size_t index) const noexcept(false);
+
+        /**
+         * @brief Gets a view of the string at the given index without checking it
+         *
+         * @param index index of the string, it should be less than the number of strings
+         * @return view of the string's characters
+         */
+        [[nodiscard]] SimpleStringView operator[](const size_t index) const noexcept {
+            const auto begin = offsets_[index];
+            return SimpleStringView(characters_.data() + begin, offsets_[index + 1] - begin);
+        }
+
+        [[nodiscard]] Iterator begin() const noexcept;
+
+        [[nodiscard]] Iterator end() const noexcept;
+
+        /**
+         * @brief Gets the index of the first string equal to the given one
+         *
+         * @param value string to look up
+         * @return optional of the string's index if it was found or an empty optional otherwise
+         * @note only the strings of the same length are compared character by character
+         */
+        [[nodiscard]] std::optional<size_t> find(SimpleStringView value) const noexcept;
+
+        /**
+         * @brief Checks which strings are equal to the given one
+         *
+         * @param value string to compare with
+         * @return flag of each string which is {@code true} if the string is equal to the value
+         * @note only the strings of the same length are compared character by character
+         */
+        [[nodiscard]] std::vector<bool> equals(SimpleStringView value) const;
+
+        /**
+         * @brief Compares each string with the given one
+         *
+         * @param value string to compare with
+         * @return result of {@link SimpleStringView#compare()} of each string with the value
+         */
+        [[nodiscard]] std::vector<int> compare(SimpleStringView value) const;
+
+        /**
+         * @brief Finds the given string in each string
+         *
+         * @param other string to find
+         * @return index of the first occurrence in each string (or an empty optional if there is none)
+         * @note the needle is compiled only once for the whole column
+         */
+        [[nodiscard]] std::vector<std::optional<size_t>> index_of(SimpleStringView other) const;
+
+        /*
+         * Public methods
+         */
+
+        /**
+         * @brief Reserves the space for the given number of strings and characters
+         *
+         * @param string_count total number of strings which should fit without reallocation
+         * @param character_count total number of characters which should fit without reallocation
+         */
+        void reserve(size_t string_count, size_t character_count);
+
+        /**
+         * @brief Appends a copy of the given string to the end of this column
+         *
+         * @param value string to append, it may be a view of this column
+         * @note if the append fails this column is left unchanged
+         */
+        void push_back(SimpleStringView value);
+
+        /**
+         * @brief Appends a copy of the given string to the end of this column
+         *
+         * @param value string to append
+         */
+        void push_back(const SimpleString &value);
+
+        /**
+         * @brief Removes all strings keeping the reserved space
+         */
+        void clear() noexcept;
+    };
+}
+
+#endif //SEM_2_LAB_1_STRING_COLUMN_H
@@ -0,0 +1,107 @@
+#include "string_hash.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace lab::hashing {
+
+    /*
+     * wyhash primitives
+     */
+
+    static constexpr uint64_t secret[4]{
+            0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+    };
+
+    /**
+     * @brief Multiplies the values storing the low half of the 128-bit product in the first one and the high in the second
+     */
+    static inline void multiply(uint64_t &first, uint64_t &second) noexcept {
+#ifdef __SIZEOF_INT128__
+        const auto product = static_cast<unsigned __int128>(first) * second;
+        first = static_cast<uint64_t>(product);
+        second = static_cast<uint64_t>(product >> 64u);
+#else
+        const auto first_high = first >> 32u, first_low = first & 0xFFFFFFFFu,
+                second_high = second >> 32u, second_low = second & 0xFFFFFFFFu;
+        const auto high_high = first_high * second_high, high_low = first_high * second_low,
+                low_high = first_low * second_high, low_low = first_low * second_low;
+        const auto middle = (low_low >> 32u) + (high_low & 0xFFFFFFFFu) + (low_high & 0xFFFFFFFFu);
+
+        first = (middle << 32u) | (low_low & 0xFFFFFFFFu);
+        second = high_high + (high_low >> 32u) + (low_high >> 32u) + (middle >> 32u);
+#endif
+    }
+
+    static inline uint64_t mix(uint64_t first, uint64_t second) noexcept {
+        multiply(first, second);
+        return first ^ second;
+    }
+
+    static inline uint64_t read8(const unsigned char *const bytes) noexcept {
+        uint64_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+
+        return value;
+    }
+
+    static inline uint64_t read4(const unsigned char *const bytes) noexcept {
+        uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+
+        return value;
+    }
+
+    static inline uint64_t read_up_to_3(const unsigned char *const bytes, const size_t count) noexcept {
+        return (uint64_t(bytes[0]) << 16u) | (uint64_t(bytes[count >> 1u]) << 8u) | bytes[count - 1];
+    }
+
+    /*
+     * Public functions
+     */
+
+    size_t hash_of(const wchar_t *const characters, const size_t length, const size_t seed) noexcept {
+        auto bytes = reinterpret_cast<const unsigned char *>(characters);
+        const size_t size = length * sizeof(wchar_t);
+
+        uint64_t state = seed ^ mix(seed ^ secret[0], secret[1]), first, second;
+        if (size <= 16) {
+            if (size >= 4) {
+                const auto middle = (size >> 3u) << 2u;
+                first = (read4(bytes) << 32u) | read4(bytes + middle);
+                second = (read4(bytes + size - 4) << 32u) | read4(bytes + size - 4 - middle);
+            } else if (size > 0) {
+                first = read_up_to_3(bytes, size);
+                second = 0;
+            } else first = second = 0;
+        } else {
+            auto remaining = size;
+            if (remaining > 48) {
+                // three independent lanes so that the multiplications overlap
+                auto second_state = state, third_state = state;
+                do {
+                    state = mix(read8(bytes) ^ secret[1], read8(bytes + 8) ^ state);
+                    second_state = mix(read8(bytes + 16) ^ secret[2], read8(bytes + 24) ^ second_state);
+                    third_state = mix(read8(bytes + 32) ^ secret[3], read8(bytes + 40) ^ third_state);
+                    bytes += 48;
+                    remaining -= 48;
+                } while (remaining > 48);
+                state ^= second_state ^ third_state;
+            }
+            while (remaining > 16) {
+                state = mix(read8(bytes) ^ secret[1], read8(bytes + 8) ^ state);
+                bytes += 16;
+                remaining -= 16;
+            }
+            // the last 16 bytes may overlap the already consumed ones
+            first = read8(bytes + remaining - 16);
+            second = read8(bytes + remaining - 8);
+        }
+
+        first ^= secret[1];
+        second ^= state;
+        multiply(first, second);
+
+        return size_t(mix(first ^ secret[0] ^ size, second ^ secret[1]));
+    }
+}
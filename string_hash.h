@@ -0,0 +1,26 @@
+#ifndef SEM_2_LAB_1_STRING_HASH_H
+#define SEM_2_LAB_1_STRING_HASH_H
+
+
+#include <cstddef>
+
+namespace lab::hashing {
+
+    /**
+     * @brief Seed used when no other one is given
+     */
+    constexpr size_t default_seed = 0;
+
+    /**
+     * @brief Hashes the given characters
+     *
+     * @param characters characters to hash
+     * @param length number of characters
+     * @param seed value mixed into the hash so that different tables may use independent hash functions
+     * @return hash of the characters, equal characters always have equal hashes
+     * @note this is wyhash which consumes 48 bytes per iteration using three independent 128-bit multiplication lanes
+     */
+    [[nodiscard]] size_t hash_of(const wchar_t *characters, size_t length, size_t seed = default_seed) noexcept;
+}
+
+#endif //SEM_2_LAB_1_STRING_HASH_H
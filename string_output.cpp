@@ -0,0 +1,121 @@
+#include "string_output.h"
+#include "utf8.h"
+
+#include <streambuf>
+#include <algorithm>
+#include <type_traits>
+
+namespace lab::output {
+
+    /*
+     * Static functions
+     */
+
+    /**
+     * @brief Size of the stack buffer in which the characters are converted before being written
+     */
+    static constexpr size_t chunk_size = 1024;
+
+    template<typename TChar, typename TTraits>
+    static inline bool put(std::basic_streambuf<TChar, TTraits> &buffer, const TChar *const characters,
+                           const size_t length) {
+        return length == 0 || buffer.sputn(characters, std::streamsize(length)) == std::streamsize(length);
+    }
+
+    /**
+     * @brief Encodes the wide characters in UTF-8 writing them in chunks
+     */
+    static bool write_utf8(std::streambuf &buffer, const wchar_t *const characters, const size_t length) {
+        // every wide character takes at most 4 bytes (a UTF-16 surrogate pair takes 4 bytes for 2 characters)
+        constexpr auto characters_per_chunk = chunk_size / 4;
+
+        char chunk[chunk_size];
+        for (size_t i = 0; i < length;) {
+            auto count = std::min(characters_per_chunk, length - i);
+            if constexpr (sizeof(wchar_t) == 2) {
+                // surrogate pairs are not split between the chunks
+                const auto last = std::make_unsigned_t<wchar_t>(characters[i + count - 1]);
+                if (count > 1 && i + count < length && last >= 0xD800 && last < 0xDC00) --count;
+            }
+            if (!put(buffer, chunk, utf8::encode(characters + i, count, chunk))) return false;
+            i += count;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Encodes the code points in UTF-8 writing them in chunks
+     */
+    template<typename TCodeUnit>
+    static bool write_utf8(std::streambuf &buffer, const TCodeUnit *const units, const size_t length) {
+        char chunk[chunk_size];
+        const auto chunk_end = chunk + chunk_size - 4;
+
+        auto output = chunk;
+        for (size_t i = 0; i < length;) {
+            // ASCII runs are copied without branching on the encoded length
+            while (i < length && output < chunk_end && std::make_unsigned_t<TCodeUnit>(units[i]) < 0x80)
+                *output++ = char(units[i++]);
+
+            if (i < length && output < chunk_end) {
+                output = utf8::encode(char32_t(units[i++]), output);
+            }
+
+            if (output >= chunk_end) {
+                if (!put(buffer, chunk, size_t(output - chunk))) return false;
+                output = chunk;
+            }
+        }
+
+        return put(buffer, chunk, size_t(output - chunk));
+    }
+
+    template<typename TCodeUnit>
+    static bool write_wide(std::wstreambuf &buffer, const TCodeUnit *const units, const size_t length) {
+        wchar_t chunk[chunk_size];
+        for (size_t i = 0; i < length; i += chunk_size) {
+            const auto count = std::min(chunk_size, length - i);
+            std::copy(units + i, units + i + count, chunk);
+            if (!put(buffer, chunk, count)) return false;
+        }
+
+        return true;
+    }
+
+    /*
+     * Public functions
+     */
+
+    bool write(std::streambuf &buffer, const wchar_t *const characters, const size_t length) {
+        return write_utf8(buffer, characters, length);
+    }
+
+    bool write(std::streambuf &buffer, const std::uint8_t *const characters, const size_t length) {
+        return write_utf8(buffer, characters, length);
+    }
+
+    bool write(std::streambuf &buffer, const std::uint16_t *const characters, const size_t length) {
+        return write_utf8(buffer, characters, length);
+    }
+
+    bool write(std::streambuf &buffer, const std::uint32_t *const characters, const size_t length) {
+        return write_utf8(buffer, characters, length);
+    }
+
+    bool write(std::wstreambuf &buffer, const wchar_t *const characters, const size_t length) {
+        return put(buffer, characters, length);
+    }
+
+    bool write(std::wstreambuf &buffer, const std::uint8_t *const characters, const size_t length) {
+        return write_wide(buffer, characters, length);
+    }
+
+    bool write(std::wstreambuf &buffer, const std::uint16_t *const characters, const size_t length) {
+        return write_wide(buffer, characters, length);
+    }
+
+    bool write(std::wstreambuf &buffer, const std::uint32_t *const characters, const size_t length) {
+        return write_wide(buffer, characters, length);
+    }
+}
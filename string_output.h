@@ -0,0 +1,90 @@
+#ifndef SEM_2_LAB_1_STRING_OUTPUT_H
+#define SEM_2_LAB_1_STRING_OUTPUT_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <ostream>
+
+/**
+ * @brief Bulk output of characters to stream buffers shared by all string types
+ *
+ * @note narrow streams receive UTF-8, characters which are not valid code points are written as U+FFFD
+ */
+namespace lab::output {
+
+    /**
+     * @brief Writes the characters to the narrow stream buffer encoding them in UTF-8
+     *
+     * @param buffer stream buffer to write to
+     * @param characters characters to write
+     * @param length number of characters
+     * @return {@code true} if everything was written and {@code false} otherwise
+     */
+    [[nodiscard]] bool write(std::streambuf &buffer, const wchar_t *characters, size_t length);
+
+    [[nodiscard]] bool write(std::streambuf &buffer, const std::uint8_t *characters, size_t length);
+
+    [[nodiscard]] bool write(std::streambuf &buffer, const std::uint16_t *characters, size_t length);
+
+    [[nodiscard]] bool write(std::streambuf &buffer, const std::uint32_t *characters, size_t length);
+
+    /**
+     * @brief Writes the characters to the wide stream buffer
+     *
+     * @param buffer stream buffer to write to
+     * @param characters characters to write
+     * @param length number of characters
+     * @return {@code true} if everything was written and {@code false} otherwise
+     */
+    [[nodiscard]] bool write(std::wstreambuf &buffer, const wchar_t *characters, size_t length);
+
+    [[nodiscard]] bool write(std::wstreambuf &buffer, const std::uint8_t *characters, size_t length);
+
+    [[nodiscard]] bool write(std::wstreambuf &buffer, const std::uint16_t *characters, size_t length);
+
+    [[nodiscard]] bool write(std::wstreambuf &buffer, const std::uint32_t *characters, size_t length);
+
+    /**
+     * @brief Writes a string to the stream as a formatted output function (padding it to the stream's width)
+     *
+     * @param out stream to write to
+     * @param length number of characters in the string
+     * @param write_characters writes the characters to the given stream buffer returning {@code false} on failure
+     * @return the stream
+     */
+    template<typename TChar, typename TTraits, typename TWrite>
+    std::basic_ostream<TChar, TTraits> &write_formatted(std::basic_ostream<TChar, TTraits> &out, const size_t length,
+                                                         TWrite &&write_characters) {
+        const typename std::basic_ostream<TChar, TTraits>::sentry sentry(out);
+        if (!sentry) return out;
+
+        auto &buffer = *out.rdbuf();
+        const auto width = out.width() > 0 ? size_t(out.width()) : 0;
+        const auto padding = width > length ? width - length : 0;
+        const auto left = (out.flags() & std::ios_base::adjustfield) == std::ios_base::left;
+        const auto fill = out.fill();
+        const auto pad = [&]() {
+            for (size_t i = 0; i < padding; ++i)
+                if (TTraits::eq_int_type(buffer.sputc(fill), TTraits::eof())) return false;
+            return true;
+        };
+
+        auto written = false;
+        try {
+            written = (left || pad()) && write_characters(buffer) && (!left || pad());
+        } catch (...) {
+            out.width(0);
+            out.setstate(std::ios_base::badbit);
+            if (out.exceptions() & std::ios_base::badbit) throw;
+            return out;
+        }
+        out.width(0);
+        if (!written) out.setstate(std::ios_base::badbit);
+
+        return out;
+    }
+}
+
+#endif //SEM_2_LAB_1_STRING_OUTPUT_H
@@ -0,0 +1,475 @@
+#include "string_search.h"
+#include "simd_kernels.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace lab {
+
+    namespace search {
+
+        /*
+         * Static functions
+         */
+
+        /**
+         * @brief Number of compared characters allowed per haystack position before falling back to Two-Way
+         */
+        static constexpr size_t work_factor = 4;
+
+        /**
+         * @brief Number of compared characters allowed regardless of the haystack position
+         * before falling back to Two-Way
+         */
+        static constexpr size_t base_work = 256;
+
+        /**
+         * @brief Characters of a buffer accessed from its end, used to run Two-Way algorithm backwards
+         */
+        struct Reversed {
+
+            /**
+             * @brief The last character of the buffer
+             */
+            const wchar_t *last;
+
+            wchar_t operator[](const std::ptrdiff_t index) const noexcept {
+                return last[-index];
+            }
+
+            Reversed operator+(const size_t offset) const noexcept {
+                return Reversed{last - offset};
+            }
+        };
+
+        /**
+         * @brief Code units of a buffer accessed as their values so that the buffers of different widths are comparable
+         */
+        template<typename TCodeUnit>
+        struct CodeUnits {
+
+            /**
+             * @brief The first code unit of the buffer
+             */
+            const TCodeUnit *first;
+
+            std::uint32_t operator[](const std::ptrdiff_t index) const noexcept {
+                return first[index];
+            }
+
+            CodeUnits operator+(const size_t offset) const noexcept {
+                return CodeUnits{first + offset};
+            }
+        };
+
+        /**
+         * @brief Computes the maximal suffix of the needle
+         *
+         * @param needle characters of the needle (or {@link Reversed} ones)
+         * @param needle_length number of characters in the needle
+         * @param reversed whether the reversed order of characters should be used
+         * @param period period of the maximal suffix to be set
+         * @return position preceding the maximal suffix
+         */
+        template<typename TCharacters>
+        static std::ptrdiff_t maximal_suffix(const TCharacters needle, const std::ptrdiff_t needle_length,
+                                             const bool reversed, size_t &period) noexcept {
+            std::ptrdiff_t suffix = -1, index = 0, offset = 1;
+            period = 1;
+
+            while (index + offset < needle_length) {
+                const auto character = needle[index + offset], suffix_character = needle[suffix + offset];
+                if (reversed ? character > suffix_character : character < suffix_character) {
+                    index += offset;
+                    offset = 1;
+                    period = size_t(index - suffix);
+                } else if (character == suffix_character) {
+                    if (size_t(offset) != period) ++offset;
+                    else {
+                        index += std::ptrdiff_t(period);
+                        offset = 1;
+                    }
+                } else {
+                    suffix = index;
+                    index = suffix + 1;
+                    offset = 1;
+                    period = 1;
+                }
+            }
+
+            return suffix;
+        }
+
+        /**
+         * @brief Finds the first occurrence of the needle in the haystack using Crochemore-Perrin Two-Way algorithm
+         *
+         * @param pattern data precomputed for the needle
+         * @param needle characters of the needle (or {@link Reversed} ones)
+         * @param needle_length number of characters in the needle, it is not greater than {@code length}
+         * @param haystack characters to search in (or {@link Reversed} ones)
+         * @param length number of characters in the haystack
+         * @param start first position of the haystack to check
+         * @return index of the first occurrence at or after {@code start} or {@code length} if there is none
+         */
+        template<typename TNeedle, typename THaystack>
+        static size_t find_two_way(const Pattern &pattern, const TNeedle needle, const size_t needle_length,
+                                   const THaystack haystack, const size_t length, size_t start) noexcept {
+            const auto critical_position = pattern.critical_position;
+            const auto period = pattern.period;
+            const auto signed_needle_length = std::ptrdiff_t(needle_length);
+            const auto last_position = length - needle_length;
+
+            if (pattern.periodic) {
+                // prefix of length `memory + 1` is known to match after a shift by the period
+                std::ptrdiff_t memory = -1;
+                while (start <= last_position) {
+                    const auto window = haystack + start;
+
+                    auto index = std::max(critical_position, memory) + 1;
+                    while (index < signed_needle_length && needle[index] == window[index]) ++index;
+                    if (index >= signed_needle_length) {
+                        index = critical_position;
+                        while (index > memory && needle[index] == window[index]) --index;
+                        if (index <= memory) return start;
+
+                        start += period;
+                        memory = signed_needle_length - std::ptrdiff_t(period) - 1;
+                    } else {
+                        start += size_t(index - critical_position);
+                        memory = -1;
+                    }
+                }
+            } else while (start <= last_position) {
+                const auto window = haystack + start;
+
+                auto index = critical_position + 1;
+                while (index < signed_needle_length && needle[index] == window[index]) ++index;
+                if (index >= signed_needle_length) {
+                    index = critical_position;
+                    while (index >= 0 && needle[index] == window[index]) --index;
+                    if (index < 0) return start;
+
+                    start += period;
+                } else start += size_t(index - critical_position);
+            }
+
+            return length;
+        }
+
+        /**
+         * @brief Finds the first occurrence of the short needle in the haystack
+         * verifying positions whose first and last characters match the needle's ones
+         *
+         * @param pattern data precomputed for the needle
+         * @param needle characters of the needle, there are at least {@code 2} of them
+         * @param needle_length number of characters in the needle, it is not greater than {@code length}
+         * @param haystack characters to search in
+         * @param length number of characters in the haystack
+         * @return index of the first occurrence or {@code length} if there is none
+         */
+        static size_t find_short(const Pattern &pattern, const wchar_t *const needle, const size_t needle_length,
+                                 const wchar_t *const haystack, const size_t length) noexcept {
+            const auto first = needle[0], last = needle[needle_length - 1];
+            const auto middle_length = needle_length - 2;
+            const auto count = length - needle_length + 1;
+
+            size_t position = 0, work = 0;
+            while (position < count) {
+                const auto found = simd::find_pair(
+                        haystack + position, count - position, first, last, needle_length - 1
+                );
+                if (found == count - position) break;
+
+                position += found;
+                const auto matched = simd::mismatch(needle + 1, haystack + position + 1, middle_length);
+                if (matched == middle_length) return position;
+
+                work += matched + 1;
+                if (work > work_factor * position + base_work) return find_two_way(
+                        pattern, needle, needle_length, haystack, length, position + 1
+                );
+                ++position;
+            }
+
+            return length;
+        }
+
+        /**
+         * @brief Finds the first occurrence of the long needle in the haystack using Boyer-Moore-Horspool algorithm
+         *
+         * @param pattern data precomputed for the needle
+         * @param needle characters of the needle, there are at least {@code 2} of them
+         * @param needle_length number of characters in the needle, it is not greater than {@code length}
+         * @param haystack characters to search in
+         * @param length number of characters in the haystack
+         * @return index of the first occurrence or {@code length} if there is none
+         */
+        static size_t find_long(const Pattern &pattern, const wchar_t *const needle, const size_t needle_length,
+                                const wchar_t *const haystack, const size_t length) noexcept {
+            const auto last_index = needle_length - 1;
+            const auto last = needle[last_index];
+            const auto last_position = length - needle_length;
+            const auto shifts = pattern.shifts;
+
+            size_t position = 0, work = 0;
+            while (position <= last_position) {
+                const auto character = haystack[position + last_index];
+                if (character == last) {
+                    const auto matched = simd::mismatch(needle, haystack + position, last_index);
+                    if (matched == last_index) return position;
+
+                    work += matched + 1;
+                    if (work > work_factor * position + base_work) return find_two_way(
+                            pattern, needle, needle_length, haystack, length, position + 1
+                    );
+                }
+
+                position += shifts[static_cast<unsigned char>(character)];
+            }
+
+            return length;
+        }
+
+        /**
+         * @brief Computes the critical factorization of the needle used by Two-Way algorithm
+         *
+         * @param pattern pattern whose factorization should be set
+         * @param needle characters of the needle (or {@link Reversed} ones), there are at least {@code 2} of them
+         * @param needle_length number of characters in the needle
+         */
+        template<typename TCharacters>
+        static void factorize(Pattern &pattern, const TCharacters needle, const size_t needle_length) noexcept {
+            // critical factorization is the later of the maximal suffixes for both orders
+            size_t period, reversed_period;
+            const auto suffix = maximal_suffix(needle, std::ptrdiff_t(needle_length), false, period),
+                    reversed_suffix = maximal_suffix(needle, std::ptrdiff_t(needle_length), true, reversed_period);
+            if (suffix > reversed_suffix) {
+                pattern.critical_position = suffix;
+                pattern.period = period;
+            } else {
+                pattern.critical_position = reversed_suffix;
+                pattern.period = reversed_period;
+            }
+
+            const auto left_length = size_t(pattern.critical_position + 1);
+            pattern.periodic = true;
+            for (size_t i = 0; i < left_length && pattern.periodic; ++i)
+                pattern.periodic = needle[std::ptrdiff_t(i)] == needle[std::ptrdiff_t(i + pattern.period)];
+            if (!pattern.periodic) pattern.period = std::max(left_length, needle_length - left_length) + 1;
+        }
+
+        /*
+         * Public functions
+         */
+
+        void compile(Pattern &pattern, const wchar_t *const needle, const size_t needle_length) noexcept {
+            if (needle_length == 0) {
+                pattern.strategy = Strategy::EMPTY;
+                return;
+            }
+            if (needle_length == 1) {
+                pattern.strategy = Strategy::CHARACTER;
+                return;
+            }
+
+            pattern.strategy = needle_length <= short_needle_length ? Strategy::SHORT : Strategy::LONG;
+            factorize(pattern, needle, needle_length);
+
+            if (pattern.strategy == Strategy::LONG) {
+                const auto shifts = pattern.shifts;
+                std::fill(shifts, shifts + shift_table_size, needle_length);
+                // characters sharing the low byte share the bucket so the smallest shift wins
+                for (size_t i = 0, last_index = needle_length - 1; i < last_index; ++i)
+                    shifts[static_cast<unsigned char>(needle[i])] = last_index - i;
+            }
+        }
+
+        size_t find(const Pattern &pattern, const wchar_t *const needle, const size_t needle_length,
+                    const wchar_t *const haystack, const size_t length) noexcept {
+            if (needle_length == 0) return 0;
+            if (needle_length > length) return length;
+
+            switch (pattern.strategy) {
+                case Strategy::CHARACTER: return simd::find_character(haystack, length, needle[0]);
+                case Strategy::SHORT: return find_short(pattern, needle, needle_length, haystack, length);
+                case Strategy::LONG: return find_long(pattern, needle, needle_length, haystack, length);
+                default: return 0;
+            }
+        }
+
+        template<typename TNeedle, typename THaystack>
+        size_t find_code_units(const TNeedle *const needle, const size_t needle_length,
+                               const THaystack *const haystack, const size_t length) noexcept {
+            if (needle_length == 0) return 0;
+            if (needle_length > length) return length;
+            if (needle_length == 1) {
+                const std::uint32_t character = needle[0];
+                for (size_t i = 0; i < length; ++i) if (haystack[i] == character) return i;
+
+                return length;
+            }
+
+            // only the factorization is needed so the shift table is left uninitialized
+            Pattern pattern;
+            factorize(pattern, CodeUnits<TNeedle>{needle}, needle_length);
+
+            return find_two_way(pattern, CodeUnits<TNeedle>{needle}, needle_length,
+                                CodeUnits<THaystack>{haystack}, length, 0);
+        }
+
+        template size_t find_code_units(const std::uint8_t *, size_t, const std::uint8_t *, size_t) noexcept;
+        template size_t find_code_units(const std::uint8_t *, size_t, const std::uint16_t *, size_t) noexcept;
+        template size_t find_code_units(const std::uint8_t *, size_t, const std::uint32_t *, size_t) noexcept;
+        template size_t find_code_units(const std::uint16_t *, size_t, const std::uint8_t *, size_t) noexcept;
+        template size_t find_code_units(const std::uint16_t *, size_t, const std::uint16_t *, size_t) noexcept;
+        template size_t find_code_units(const std::uint16_t *, size_t, const std::uint32_t *, size_t) noexcept;
+        template size_t find_code_units(const std::uint32_t *, size_t, const std::uint8_t *, size_t) noexcept;
+        template size_t find_code_units(const std::uint32_t *, size_t, const std::uint16_t *, size_t) noexcept;
+        template size_t find_code_units(const std::uint32_t *, size_t, const std::uint32_t *, size_t) noexcept;
+
+        void compile_reversed(Pattern &pattern, const wchar_t *const needle, const size_t needle_length) noexcept {
+            if (needle_length == 0) {
+                pattern.strategy = Strategy::EMPTY;
+                return;
+            }
+            if (needle_length == 1) {
+                pattern.strategy = Strategy::CHARACTER;
+                return;
+            }
+
+            // the last occurrence is the first one of the reversed needle in the reversed haystack
+            pattern.strategy = Strategy::LONG;
+            factorize(pattern, Reversed{needle + needle_length - 1}, needle_length);
+        }
+
+        size_t find_last(const Pattern &pattern, const wchar_t *const needle, const size_t needle_length,
+                         const wchar_t *const haystack, const size_t length) noexcept {
+            if (needle_length == 0) return length;
+            if (needle_length > length) return length;
+            if (pattern.strategy == Strategy::CHARACTER) return simd::find_last_character(haystack, length, needle[0]);
+
+            const auto index = find_two_way(pattern, Reversed{needle + needle_length - 1}, needle_length,
+                                            Reversed{haystack + length - 1}, length, 0);
+            return index == length ? length : length - index - needle_length;
+        }
+
+        /**
+         * @brief Length of the haystacks from which they are searched in parallel
+         */
+        static std::atomic<size_t> parallel_threshold_{default_parallel_threshold};
+
+        /**
+         * @brief Searches the chunks of the haystack in parallel keeping the leftmost occurrence
+         *
+         * @param length number of positions at which the occurrence may start
+         * @param overlap number of characters past its last position which the search of a chunk may read
+         * @param pool pool running the searches of the chunks
+         * @param find_in_chunk function finding the first occurrence starting in {@code [begin, end)}
+         * which gets {@code begin} and the number of readable characters and returns the occurrence's index
+         * relative to {@code begin} or at least {@code end - begin} if there is none
+         * @return index of the first occurrence or {@code length} if there is none
+         * @note if the pool fails to run the searches the whole haystack is searched by the calling thread
+         */
+        template<typename TFindInChunk>
+        static size_t find_in_chunks(const size_t length, const size_t overlap, ThreadPool &pool,
+                                     const TFindInChunk &find_in_chunk) noexcept {
+            // chunks are taken in order so the later ones get cancelled once an occurrence is found
+            const auto chunk = std::max(parallel_chunk_length, overlap);
+            const auto chunk_count = (length + chunk - 1) / chunk;
+            if (chunk_count <= 1 || pool.concurrency() == 1) return find_in_chunk(0, length + overlap);
+
+            std::atomic<size_t> first{length};
+            const auto search_chunk = [&](const size_t task) {
+                const auto begin = task * chunk;
+                if (begin >= first.load(std::memory_order_relaxed)) return;
+
+                const auto end = std::min(begin + chunk, length);
+                const auto index = find_in_chunk(begin, end - begin + overlap);
+                if (index >= end - begin) return;
+
+                auto found = first.load(std::memory_order_relaxed);
+                while (begin + index < found
+                       && !first.compare_exchange_weak(found, begin + index, std::memory_order_relaxed)) {}
+            };
+            try {
+                // the task only refers to the frame so that it is stored in std::function without allocation
+                pool.run(chunk_count, [&search_chunk](const size_t task) { search_chunk(task); });
+            } catch (...) {
+                // the searches do not throw so the pool itself has failed to submit the job
+                return find_in_chunk(0, length + overlap);
+            }
+
+            return first.load(std::memory_order_relaxed);
+        }
+
+        size_t parallel_threshold() noexcept {
+            return parallel_threshold_.load(std::memory_order_relaxed);
+        }
+
+        void set_parallel_threshold(const size_t threshold) noexcept {
+            parallel_threshold_.store(threshold, std::memory_order_relaxed);
+        }
+
+        size_t find_parallel(const Pattern &pattern, const wchar_t *const needle, const size_t needle_length,
+                             const wchar_t *const haystack, const size_t length, ThreadPool &pool) noexcept {
+            if (needle_length == 0) return 0;
+            if (needle_length > length) return length;
+
+            const auto overlap = needle_length - 1, start_count = length - overlap;
+            const auto index = find_in_chunks(start_count, overlap, pool,
+                                              [&](const size_t begin, const size_t readable) {
+                return find(pattern, needle, needle_length, haystack + begin, readable);
+            });
+
+            return index == start_count ? length : index;
+        }
+
+        size_t find_character_parallel(const wchar_t *const haystack, const size_t length, const wchar_t character,
+                                       ThreadPool &pool) noexcept {
+            return find_in_chunks(length, 0, pool, [&](const size_t begin, const size_t readable) {
+                return simd::find_character(haystack + begin, readable, character);
+            });
+        }
+
+        size_t find_parallel(const Pattern &pattern, const wchar_t *const needle, const size_t needle_length,
+                             const wchar_t *const haystack, const size_t length) noexcept {
+            // the global pool has no workers rather than throwing if they cannot be started
+            return find_parallel(pattern, needle, needle_length, haystack, length, ThreadPool::global());
+        }
+
+        size_t find_character_parallel(const wchar_t *const haystack, const size_t length,
+                                       const wchar_t character) noexcept {
+            return find_character_parallel(haystack, length, character, ThreadPool::global());
+        }
+    }
+
+    /*
+     * Public constructors
+     */
+
+    Searcher::Searcher(const SimpleString &needle) : needle_(needle), pattern_() {
+        search::compile(pattern_, needle_.buffer_, needle_.length_);
+    }
+
+    /*
+     * Constant public methods
+     */
+
+    const SimpleString &Searcher::needle() const noexcept {
+        return needle_;
+    }
+
+    search::Strategy Searcher::strategy() const noexcept {
+        return pattern_.strategy;
+    }
+
+    std::optional<size_t> Searcher::find_in(const SimpleStringView haystack) const noexcept {
+        const auto length = haystack.length();
+        const auto index = length < search::parallel_threshold()
+                ? search::find(pattern_, needle_.buffer_, needle_.length_, haystack.data(), length)
+                : search::find_parallel(pattern_, needle_.buffer_, needle_.length_, haystack.data(), length);
+
+        return index == length && !needle_.empty() ? std::optional<size_t>() : std::optional<size_t>(index);
+    }
+}
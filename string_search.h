@@ -0,0 +1,71 @@
+#ifndef SEM_2_LAB_1_STRING_SEARCH_H
+#define SEM_2_LAB_1_STRING_SEARCH_H
+
+
+#include "simple_string.h"
+#include "search_pattern.h"
+
+#include <cstddef>
+#include <optional>
+
+namespace lab {
+
+    /**
+     * @brief Reusable searcher of a single needle which precomputes all needle-dependent data only once
+     */
+    class Searcher {
+    protected:
+
+        /**
+         * @brief Needle to find
+         */
+        SimpleString needle_;
+
+        /**
+         * @brief Data precomputed for {@code needle_}
+         */
+        search::Pattern pattern_;
+
+    public:
+
+        /*
+         * Public constructors
+         */
+
+        /**
+         * @brief Creates a new searcher of the given needle
+         *
+         * @param needle string to find, it is copied into the searcher
+         */
+        explicit Searcher(const SimpleString &needle);
+
+        /*
+         * Constant public methods
+         */
+
+        /**
+         * @brief Gets the needle found by this searcher
+         *
+         * @return needle of this searcher
+         */
+        [[nodiscard]] const SimpleString &needle() const noexcept;
+
+        /**
+         * @brief Gets the algorithm chosen for the needle
+         *
+         * @return strategy of this searcher
+         */
+        [[nodiscard]] search::Strategy strategy() const noexcept;
+
+        /**
+         * @brief Gets an index of the first occurrence of the needle in the given string
+         *
+         * @param haystack string to search in
+         * @return optional of needle's index if it was found or an empty optional otherwise
+         * @note haystacks of at least {@link search::parallel_threshold()} characters are searched in parallel
+         */
+        [[nodiscard]] std::optional<size_t> find_in(SimpleStringView haystack) const noexcept;
+    };
+}
+
+#endif //SEM_2_LAB_1_STRING_SEARCH_H
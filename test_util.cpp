@@ -1,11 +1,21 @@
 #include "test_util.h"
 
+#include <sstream>
+
 namespace tests {
 
     void fail(const char *const message) {
         std::cerr << message << std::endl;
     }
 
+    std::string printable(const wchar_t &value) {
+        std::ostringstream out;
+        if (value >= L' ' && value <= L'~') out << "L'" << char(value) << '\'';
+        else out << "U+" << std::hex << std::uppercase << static_cast<unsigned long>(value);
+
+        return out.str();
+    }
+
     void assert_true(const bool actual, const char *const &file, const size_t line) {
         if (!actual) std::cerr << "Expected:\n\ttrue\nActual:\n\tfalse\nat " << file << ':' << line << std::endl;
     }
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <optional>
+#include <string>
 
 #define ASSERT_EQUALS(expected, actual) tests::assert_equals(expected, actual, __FILE__, __LINE__);
 
@@ -37,19 +38,38 @@ namespace tests {
 
     void fail(const char *message);
 
+    /**
+     * @brief Gets the representation of the value which can be written to a narrow output stream
+     *
+     * @param value value to be represented
+     * @return value itself
+     */
+    template<typename T>
+    const T &printable(const T &value) {
+        return value;
+    }
+
+    /**
+     * @brief Gets the representation of the wide character which can be written to a narrow output stream
+     *
+     * @param value wide character to be represented
+     * @return quoted character if it is printable ASCII and its code point otherwise
+     */
+    std::string printable(const wchar_t &value);
+
     template<typename TExpected, typename TActual>
     void assert_equals(const TExpected &expected, const TActual &actual,
                        const char *const &file, const size_t line) {
-        if (!(expected == actual)) std::cerr << "Expected:\n\t" << expected
-                << "\nActual:\n\t" << actual
+        if (!(expected == actual)) std::cerr << "Expected:\n\t" << printable(expected)
+                << "\nActual:\n\t" << printable(actual)
                 << "\nat " << file << ':' << line << std::endl;
     }
 
     template<typename TExpected, typename TActual>
     void assert_not_equals(const TExpected &expected, const TActual &actual,
                            const char *const &file, const size_t line) {
-        if (!(expected != actual)) std::cerr << "Expected:\n\t" << expected
-                << "\nActual:\n\t" << actual
+        if (!(expected != actual)) std::cerr << "Expected:\n\t" << printable(expected)
+                << "\nActual:\n\t" << printable(actual)
                 << "\nat " << file << ':' << line << std::endl;
     }
 
@@ -58,10 +78,10 @@ namespace tests {
                                 const char *const &file, const size_t line) {
         if (actual.has_value()) {
             const auto value = actual.value();
-            if (!(value == expected)) std::cerr << "Expected:\n\toptional{" << expected
-                    << "}\nActual:\n\toptional{" << value
+            if (!(value == expected)) std::cerr << "Expected:\n\toptional{" << printable(expected)
+                    << "}\nActual:\n\toptional{" << printable(value)
                     << "}\nat " << file << ':' << line << std::endl;
-        } else std::cerr << "Expected:\n\toptional{" << expected
+        } else std::cerr << "Expected:\n\toptional{" << printable(expected)
                 << "}\nActual:\n\tEmpty optional\nat " << file << ':' << line << std::endl;
     }
 
@@ -69,7 +89,7 @@ namespace tests {
     void assert_optional_empty(const std::optional<TActual> &actual,
                                const char *const &file, const size_t line) {
         if (actual.has_value()) std::cerr << "Expected:\n\tEmpty optional"
-                << "\nActual:\n\toptional{" << actual.value()
+                << "\nActual:\n\toptional{" << printable(actual.value())
                 << "}\nat " << file << ':' << line << std::endl;
     }
 
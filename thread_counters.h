@@ -0,0 +1,150 @@
+#ifndef SEM_2_LAB_1_THREAD_COUNTERS_H
+#define SEM_2_LAB_1_THREAD_COUNTERS_H
+
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+/**
+ * @brief Per-thread counters which are written without contention but can be summed by any thread
+ *
+ * @note this is an internal header shared by the buffer cache and the instrumentation
+ */
+namespace lab::thread_counters {
+
+    /**
+     * @brief Counter written only by its thread but read by any
+     */
+    class Counter {
+        std::atomic<size_t> value_{0};
+
+    public:
+        void add(const size_t delta) noexcept {
+            value_.store(value_.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        void subtract(const size_t delta) noexcept {
+            value_.store(value_.load(std::memory_order_relaxed) - delta, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] size_t get() const noexcept {
+            return value_.load(std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Registry of the live threads' states and of the totals of the finished threads
+     *
+     * @tparam TState state of a thread whose counters are written only by that thread, it should have
+     * {@code void add_to(TTotals &totals) const noexcept} adding its counters to the totals
+     * and {@code void retire() noexcept} called when the thread finishes before its counters are added to the totals
+     * @tparam TTotals sums of the counters of the states
+     * @note there is a single registry per state type
+     */
+    template<typename TState, typename TTotals>
+    class Registry {
+        struct Node;
+
+        struct Shared {
+            std::mutex mutex;
+            Node *first = nullptr;
+            TTotals retired{};
+        };
+
+        static Shared &shared() noexcept {
+            static Shared shared;
+            return shared;
+        }
+
+        /**
+         * @brief Set once the calling thread's state is destroyed so that late updates go directly to the totals
+         */
+        static inline thread_local bool finished_ = false;
+
+        struct Node {
+            TState state;
+            Node *previous = nullptr, *next = nullptr;
+
+            Node() {
+                auto &shared = Registry::shared();
+                const std::lock_guard lock(shared.mutex);
+
+                next = shared.first;
+                if (next != nullptr) next->previous = this;
+                shared.first = this;
+            }
+
+            ~Node() {
+                state.retire();
+
+                auto &shared = Registry::shared();
+                const std::lock_guard lock(shared.mutex);
+
+                state.add_to(shared.retired);
+                if (previous != nullptr) previous->next = next;
+                else shared.first = next;
+                if (next != nullptr) next->previous = previous;
+
+                finished_ = true;
+            }
+
+            Node(const Node &other) = delete;
+
+            Node &operator=(const Node &other) = delete;
+        };
+
+    public:
+
+        Registry() = delete;
+
+        /**
+         * @brief Gets the state of the calling thread creating it on the first call
+         *
+         * @return the calling thread's state, it should not be used once {@link #finished()} is {@code true}
+         */
+        static TState &local() {
+            static thread_local Node node;
+            return node.state;
+        }
+
+        /**
+         * @brief Checks if the calling thread's state has already been destroyed
+         *
+         * @return {@code true} if the thread is finishing and its state is no longer available
+         */
+        static bool finished() noexcept {
+            return finished_;
+        }
+
+        /**
+         * @brief Updates the totals of the finished threads, e.g. with the counts of a thread without its state
+         *
+         * @param update function called with the totals while no state is being added or removed
+         */
+        template<typename TUpdate>
+        static void update_retired(TUpdate &&update) {
+            auto &shared = Registry::shared();
+            const std::lock_guard lock(shared.mutex);
+
+            update(shared.retired);
+        }
+
+        /**
+         * @brief Sums the counters of all threads
+         *
+         * @return totals of the finished threads plus the counters of the live ones
+         */
+        static TTotals total() noexcept {
+            auto &shared = Registry::shared();
+            const std::lock_guard lock(shared.mutex);
+
+            auto totals = shared.retired;
+            for (auto node = shared.first; node != nullptr; node = node->next) node->state.add_to(totals);
+
+            return totals;
+        }
+    };
+}
+
+#endif //SEM_2_LAB_1_THREAD_COUNTERS_H
@@ -0,0 +1,138 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace lab {
+
+    /*
+     * Internal types
+     */
+
+    struct ThreadPool::Job {
+        const std::function<void(size_t)> &task;
+        const size_t count;
+
+        /**
+         * @brief Index of the next task to be taken
+         */
+        size_t next = 0;
+
+        /**
+         * @brief Number of tasks which have finished
+         */
+        size_t finished = 0;
+
+        /**
+         * @brief The first exception thrown by the tasks
+         */
+        std::exception_ptr error;
+    };
+
+    /*
+     * Internal methods
+     */
+
+    void ThreadPool::execute(Job &job, std::unique_lock<std::mutex> &lock) {
+        while (job.next < job.count) {
+            const auto index = job.next++;
+            // the job leaves the queue once all of its tasks are taken
+            if (job.next == job.count) jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                job.task(index);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+
+            if (error && !job.error) job.error = error;
+            // the submitting thread may destroy the job as soon as the mutex is released
+            if (++job.finished == job.count) finished_.notify_all();
+        }
+    }
+
+    void ThreadPool::stop() noexcept {
+        {
+            const std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        submitted_.notify_all();
+
+        for (auto &worker: workers_) worker.join();
+    }
+
+    void ThreadPool::work() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            submitted_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            if (stopping_) return;
+
+            execute(*jobs_.front(), lock);
+        }
+    }
+
+    /*
+     * Public constructor and destructor
+     */
+
+    ThreadPool::ThreadPool(const size_t worker_count) {
+        try {
+            workers_.reserve(worker_count);
+            for (size_t i = 0; i < worker_count; ++i) workers_.emplace_back([this]() { work(); });
+        } catch (...) {
+            // the destructor is not run for a partially constructed pool and joinable threads must not be destroyed
+            stop();
+            throw;
+        }
+    }
+
+    ThreadPool::ThreadPool(const size_t worker_count, std::nothrow_t) noexcept {
+        try {
+            workers_.reserve(worker_count);
+            for (size_t i = 0; i < worker_count; ++i) workers_.emplace_back([this]() { work(); });
+        } catch (...) {
+            // the pool without workers runs all of the tasks in the submitting thread
+            stop();
+            workers_.clear();
+            stopping_ = false;
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        stop();
+    }
+
+    /*
+     * Public methods
+     */
+
+    ThreadPool &ThreadPool::global() noexcept {
+        static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1, std::nothrow);
+        return pool;
+    }
+
+    size_t ThreadPool::concurrency() const noexcept {
+        return workers_.size() + 1;
+    }
+
+    void ThreadPool::run(const size_t task_count, const std::function<void(size_t)> &task) {
+        if (task_count == 0) return;
+        if (workers_.empty() || task_count == 1) {
+            for (size_t i = 0; i < task_count; ++i) task(i);
+            return;
+        }
+
+        Job job{task, task_count, 0, 0, nullptr};
+        std::unique_lock lock(mutex_);
+        jobs_.push_back(&job);
+        submitted_.notify_all();
+
+        execute(job, lock);
+        finished_.wait(lock, [&job]() { return job.finished == job.count; });
+
+        if (job.error) std::rethrow_exception(job.error);
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef SEM_2_LAB_1_THREAD_POOL_H
+#define SEM_2_LAB_1_THREAD_POOL_H
+
+
+#include <cstddef>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace lab {
+
+    /**
+     * @brief Pool of worker threads running indexed tasks in parallel with the thread which has submitted them
+     *
+     * @note tasks may submit further tasks to the same pool as the submitting thread always takes part in the work
+     */
+    class ThreadPool {
+    protected:
+
+        /**
+         * @brief Tasks submitted by a single call of {@link #run(size_t, const std::function<void(size_t)> &)}
+         */
+        struct Job;
+
+        /**
+         * @brief Mutex guarding the queue and the progress of all jobs
+         */
+        std::mutex mutex_;
+
+        /**
+         * @brief Condition signalled when a job is submitted or the pool is stopping
+         */
+        std::condition_variable submitted_;
+
+        /**
+         * @brief Condition signalled when a job's last task is finished
+         */
+        std::condition_variable finished_;
+
+        /**
+         * @brief Jobs which still have tasks not taken by any thread
+         */
+        std::deque<Job *> jobs_;
+
+        /**
+         * @brief Whether the workers should exit
+         */
+        bool stopping_ = false;
+
+        std::vector<std::thread> workers_;
+
+        /**
+         * @brief Runs the tasks of the job until none is left to be taken
+         *
+         * @param job job whose tasks should be run
+         * @param lock lock of {@code mutex_} which is held except while a task is running
+         */
+        void execute(Job &job, std::unique_lock<std::mutex> &lock);
+
+        /**
+         * @brief Runs the jobs' tasks as they get submitted until the pool is stopping
+         */
+        void work();
+
+        /**
+         * @brief Makes the workers exit waiting for them to do so
+         */
+        void stop() noexcept;
+
+        /**
+         * @brief Creates a new pool without workers if any of them cannot be started
+         *
+         * @param worker_count number of worker threads, the submitting threads run the tasks as well
+         */
+        ThreadPool(size_t worker_count, std::nothrow_t) noexcept;
+
+    public:
+
+        /**
+         * @brief Creates a new pool
+         *
+         * @param worker_count number of worker threads, the submitting threads run the tasks as well
+         * @throws std::system_error if a worker cannot be started, the ones already started are stopped first
+         */
+        explicit ThreadPool(size_t worker_count);
+
+        /**
+         * @brief Stops the pool waiting for its workers to exit
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &other) = delete;
+
+        ThreadPool &operator=(const ThreadPool &other) = delete;
+
+        /**
+         * @brief Gets the pool shared by the whole program
+         *
+         * @return pool with a worker per hardware thread except the submitting one
+         * or without workers if they cannot be started
+         */
+        [[nodiscard]] static ThreadPool &global() noexcept;
+
+        /**
+         * @brief Gets the number of threads which can run tasks at the same time
+         *
+         * @return number of workers plus the submitting thread
+         */
+        [[nodiscard]] size_t concurrency() const noexcept;
+
+        /**
+         * @brief Runs {@code task(0)}, ..., {@code task(task_count - 1)} in parallel waiting for all of them to finish
+         *
+         * @param task_count number of tasks
+         * @param task function run with the index of each task
+         * @throws the first exception thrown by the tasks once all of them have finished
+         */
+        void run(size_t task_count, const std::function<void(size_t)> &task);
+    };
+}
+
+#endif //SEM_2_LAB_1_THREAD_POOL_H
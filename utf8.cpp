@@ -0,0 +1,186 @@
+#include "utf8.h"
+#include "simd_kernels.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace lab::utf8 {
+
+    /*
+     * Static functions
+     */
+
+    static constexpr bool utf16 = sizeof(wchar_t) == 2;
+
+    /**
+     * @brief Number of ASCII characters converted inline before the rest of the run is left to the vectorized kernels
+     *
+     * @note mixed text has many short ASCII runs (spaces, punctuation) for which a kernel call costs more than it saves
+     */
+    static constexpr size_t inline_ascii_run = 16;
+
+    static inline bool is_continuation(const unsigned char byte) noexcept {
+        return (byte & 0xC0u) == 0x80u;
+    }
+
+    /**
+     * @brief Gets the code point at the given position of the wide characters
+     *
+     * @param characters wide characters
+     * @param length number of characters
+     * @param index index of the character, it is moved past the decoded one
+     * @return code point or U+FFFD if the character is not a code point
+     */
+    static inline char32_t code_point_at(const wchar_t *const characters, const size_t length, size_t &index) noexcept {
+        char32_t code_point = std::make_unsigned_t<wchar_t>(characters[index++]);
+        if constexpr (utf16) {
+            if (code_point >= 0xD800 && code_point < 0xDC00 && index < length) {
+                const char32_t low = std::make_unsigned_t<wchar_t>(characters[index]);
+                if (low >= 0xDC00 && low <= 0xDFFF) {
+                    ++index;
+                    return 0x10000 + ((code_point - 0xD800) << 10u) + (low - 0xDC00);
+                }
+            }
+        }
+
+        return is_valid_code_point(code_point) ? code_point : replacement_character;
+    }
+
+    static inline size_t encoded_size_of(const char32_t code_point) noexcept {
+        return code_point < 0x80 ? 1 : code_point < 0x800 ? 2 : code_point < 0x10000 ? 3 : 4;
+    }
+
+    /*
+     * DecodingError
+     */
+
+    DecodingError::DecodingError(const char *const message, const size_t position)
+            : std::invalid_argument(message), position_(position) {}
+
+    size_t DecodingError::position() const noexcept {
+        return position_;
+    }
+
+    /*
+     * Public functions
+     */
+
+    size_t decoded_length(const char *const bytes, const size_t size) noexcept {
+        const auto code_points = simd::count_code_points(bytes, size);
+        if constexpr (utf16) {
+            // supplementary code points (4-byte sequences) take two UTF-16 code units
+            size_t supplementary = 0;
+            for (size_t i = 0; i < size; ++i) supplementary += (unsigned char) bytes[i] >= 0xF0;
+            return code_points + supplementary;
+        } else return code_points;
+    }
+
+    size_t decode(const char *const bytes, const size_t size, wchar_t *const destination) {
+        const auto input = reinterpret_cast<const unsigned char *>(bytes);
+
+        const auto kernels = simd::ascii_kernels();
+        size_t i = 0, written = 0;
+        while (i < size) {
+            if (input[i] < 0x80) {
+                const auto inline_end = std::min(size, i + inline_ascii_run);
+                while (i < inline_end && input[i] < 0x80) destination[written++] = wchar_t(input[i++]);
+                if (i == inline_end && i < size && input[i] < 0x80) {
+                    const auto ascii = kernels.ascii_length(bytes + i, size - i);
+                    kernels.widen(bytes + i, ascii, destination + written);
+                    i += ascii;
+                    written += ascii;
+                }
+                continue;
+            }
+
+            // runs of 2-byte sequences (most non-Latin alphabets) are decoded without the general validation
+            while (i + 1 < size && input[i] >= 0xC2 && input[i] <= 0xDF && is_continuation(input[i + 1])) {
+                destination[written++] = wchar_t(((input[i] & 0x1Fu) << 6u) | (input[i + 1] & 0x3Fu));
+                i += 2;
+            }
+            if (i == size || input[i] < 0x80) continue;
+
+            // other multi-byte sequences are decoded one at a time
+            const auto lead = input[i];
+            size_t sequence_length;
+            char32_t code_point, minimum;
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                sequence_length = 2;
+                code_point = lead & 0x1Fu;
+                minimum = 0x80;
+            } else if (lead >= 0xE0 && lead <= 0xEF) {
+                sequence_length = 3;
+                code_point = lead & 0x0Fu;
+                minimum = 0x800;
+            } else if (lead >= 0xF0 && lead <= 0xF4) {
+                sequence_length = 4;
+                code_point = lead & 0x07u;
+                minimum = 0x10000;
+            } else if (is_continuation(lead)) throw DecodingError("Unexpected UTF-8 continuation byte", i);
+            else throw DecodingError("Invalid UTF-8 leading byte", i);
+
+            if (sequence_length > size - i) throw DecodingError("Truncated UTF-8 sequence", i);
+            for (size_t j = 1; j < sequence_length; ++j) {
+                const auto byte = input[i + j];
+                if (!is_continuation(byte)) throw DecodingError("Truncated UTF-8 sequence", i);
+                code_point = (code_point << 6u) | (byte & 0x3Fu);
+            }
+            if (code_point < minimum) throw DecodingError("Overlong UTF-8 sequence", i);
+            if (!is_valid_code_point(code_point)) throw DecodingError("UTF-8 sequence is not a code point", i);
+
+            if constexpr (utf16) {
+                if (code_point >= 0x10000) {
+                    code_point -= 0x10000;
+                    destination[written++] = wchar_t(0xD800 + (code_point >> 10u));
+                    code_point = 0xDC00 + (code_point & 0x3FFu);
+                }
+            }
+            destination[written++] = wchar_t(code_point);
+            i += sequence_length;
+        }
+
+        return written;
+    }
+
+    size_t encoded_size(const wchar_t *const characters, const size_t length) noexcept {
+        size_t size = 0;
+        for (size_t i = 0; i < length;) size += encoded_size_of(code_point_at(characters, length, i));
+
+        return size;
+    }
+
+    size_t encode(const wchar_t *const characters, const size_t length, char *const destination) noexcept {
+        const auto is_ascii = [characters](const size_t index) {
+            return std::make_unsigned_t<wchar_t>(characters[index]) < 0x80;
+        };
+
+        const auto kernels = simd::ascii_kernels();
+        auto output = destination;
+        size_t i = 0;
+        while (i < length) {
+            if (is_ascii(i)) {
+                const auto inline_end = std::min(length, i + inline_ascii_run);
+                while (i < inline_end && is_ascii(i)) *output++ = char(characters[i++]);
+                if (i == inline_end && i < length && is_ascii(i)) {
+                    const auto ascii = kernels.narrow_ascii(characters + i, length - i, output);
+                    i += ascii;
+                    output += ascii;
+                }
+                continue;
+            }
+
+            // runs of characters taking 2 bytes are encoded without the general dispatch on the length
+            while (i < length) {
+                const auto character = std::make_unsigned_t<wchar_t>(characters[i]);
+                if (character < 0x80 || character >= 0x800) break;
+
+                *output++ = char(0xC0 | (character >> 6u));
+                *output++ = char(0x80 | (character & 0x3Fu));
+                ++i;
+            }
+            if (i < length && !is_ascii(i)) output = encode(code_point_at(characters, length, i), output);
+        }
+
+        return size_t(output - destination);
+    }
+}
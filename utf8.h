@@ -0,0 +1,127 @@
+#ifndef SEM_2_LAB_1_UTF8_H
+#define SEM_2_LAB_1_UTF8_H
+
+
+#include <cstddef>
+#include <stdexcept>
+
+/**
+ * @brief Conversion between UTF-8 and wide characters (UTF-32, or UTF-16 if {@code wchar_t} is 16-bit)
+ *
+ * @note only ASCII runs are vectorized: runs of at least 16 ASCII characters are converted by the SIMD kernels
+ * (fetched once per call), runs of 2-byte sequences by a dedicated scalar loop and the remaining sequences
+ * one at a time by scalar code
+ */
+namespace lab::utf8 {
+
+    /**
+     * @brief Error thrown when the bytes are not valid UTF-8
+     */
+    class DecodingError : public std::invalid_argument {
+        size_t position_;
+
+    public:
+
+        /**
+         * @brief Creates a new error
+         *
+         * @param message description of the error
+         * @param position index of the first byte of the invalid sequence
+         */
+        DecodingError(const char *message, size_t position);
+
+        /**
+         * @brief Gets the index of the first byte of the invalid sequence
+         *
+         * @return position of the error
+         */
+        [[nodiscard]] size_t position() const noexcept;
+    };
+
+    /**
+     * @brief Code point written in place of the characters which are not code points
+     */
+    constexpr char32_t replacement_character = 0xFFFD;
+
+    /**
+     * @brief Checks if the value is a Unicode scalar value, i.e. a code point which is not a surrogate
+     *
+     * @param code_point value to check
+     * @return {@code true} if the value can be encoded in UTF-8 and {@code false} otherwise
+     */
+    [[nodiscard]] constexpr bool is_valid_code_point(const char32_t code_point) noexcept {
+        return code_point <= 0x10FFFF && (code_point < 0xD800 || code_point > 0xDFFF);
+    }
+
+    /**
+     * @brief Encodes a single code point in UTF-8
+     *
+     * @param code_point code point to encode, values which are not code points are encoded as U+FFFD
+     * @param destination buffer of at least 4 bytes
+     * @return pointer past the last written byte
+     */
+    inline char *encode(char32_t code_point, char *destination) noexcept {
+        if (!is_valid_code_point(code_point)) code_point = replacement_character;
+
+        if (code_point < 0x80) *destination++ = char(code_point);
+        else if (code_point < 0x800) {
+            *destination++ = char(0xC0 | (code_point >> 6u));
+            *destination++ = char(0x80 | (code_point & 0x3Fu));
+        } else if (code_point < 0x10000) {
+            *destination++ = char(0xE0 | (code_point >> 12u));
+            *destination++ = char(0x80 | ((code_point >> 6u) & 0x3Fu));
+            *destination++ = char(0x80 | (code_point & 0x3Fu));
+        } else {
+            *destination++ = char(0xF0 | (code_point >> 18u));
+            *destination++ = char(0x80 | ((code_point >> 12u) & 0x3Fu));
+            *destination++ = char(0x80 | ((code_point >> 6u) & 0x3Fu));
+            *destination++ = char(0x80 | (code_point & 0x3Fu));
+        }
+
+        return destination;
+    }
+
+    /**
+     * @brief Counts the wide characters the valid UTF-8 bytes decode to
+     *
+     * @param bytes valid UTF-8 bytes
+     * @param size number of bytes
+     * @return number of wide characters, the result for invalid bytes is meaningless but not greater than {@code size}
+     */
+    [[nodiscard]] size_t decoded_length(const char *bytes, size_t size) noexcept;
+
+    /**
+     * @brief Decodes the UTF-8 bytes validating them
+     *
+     * @param bytes UTF-8 bytes
+     * @param size number of bytes
+     * @param destination buffer of at least {@link #decoded_length(const char *, size_t)} wide characters
+     * @return number of decoded characters
+     * @throws {@link DecodingError} if the bytes are not valid UTF-8 (overlong forms and surrogates are rejected)
+     * @note only ASCII runs are vectorized, multi-byte sequences are decoded by scalar code
+     */
+    size_t decode(const char *bytes, size_t size, wchar_t *destination);
+
+    /**
+     * @brief Counts the bytes the wide characters encode to
+     *
+     * @param characters wide characters
+     * @param length number of characters
+     * @return number of bytes written by {@link #encode(const wchar_t *, size_t, char *)}
+     */
+    [[nodiscard]] size_t encoded_size(const wchar_t *characters, size_t length) noexcept;
+
+    /**
+     * @brief Encodes the wide characters in UTF-8
+     *
+     * @param characters wide characters
+     * @param length number of characters
+     * @param destination buffer of at least {@link #encoded_size(const wchar_t *, size_t)} bytes
+     * @return number of written bytes
+     * @note characters which are not code points (e.g. lone surrogates) are encoded as U+FFFD
+     * @note only ASCII runs are vectorized, other characters are encoded by scalar code
+     */
+    size_t encode(const wchar_t *characters, size_t length, char *destination) noexcept;
+}
+
+#endif //SEM_2_LAB_1_UTF8_H